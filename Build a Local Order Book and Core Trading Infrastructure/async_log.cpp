@@ -0,0 +1,149 @@
+//
+// Writer side of the asynchronous event log: ring registration, drain loop, formatting.
+//
+#include "async_log.h"
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+constexpr size_t kFlushBytes = 1 << 20;  // batch size for one fwrite
+
+std::atomic<uint64_t> next_instance{1};
+
+// A thread's rings, one per logger it has written to (usually one)
+struct ThreadRings {
+    std::vector<std::pair<uint64_t, LogRing*>> rings;
+    uint64_t last_instance = 0;
+    LogRing* last_ring = nullptr;
+};
+thread_local ThreadRings tls_rings;
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 64;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger(const std::string& path, const char* const* formats, size_t nformats,
+                         Overflow overflow, size_t ring_capacity)
+    : overflow_(overflow), ring_capacity_(round_up_pow2(ring_capacity)),
+      instance_(next_instance.fetch_add(1)) {
+    formats_.resize(nformats);
+    for (size_t f = 0; f < nformats; ++f) {
+        const std::string text = formats[f];
+        size_t pos = 0, hole;
+        while ((hole = text.find("{}", pos)) != std::string::npos) {
+            formats_[f].pieces.push_back(text.substr(pos, hole - pos));
+            pos = hole + 2;
+        }
+        formats_[f].pieces.push_back(text.substr(pos));
+    }
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Error: could not create log " << path << "\n";
+        return;
+    }
+    out_.reserve(kFlushBytes + 4096);
+    writer_ = std::thread([this] { run(); });
+}
+
+AsyncLogger::~AsyncLogger() { close(); }
+
+void AsyncLogger::close() {
+    if (writer_.joinable()) {
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+LogRing& AsyncLogger::local_ring() {
+    ThreadRings& t = tls_rings;
+    if (t.last_instance == instance_) return *t.last_ring;
+    LogRing* ring = nullptr;
+    for (auto& [inst, r] : t.rings)
+        if (inst == instance_) ring = r;
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(rings_mu_);
+        rings_.push_back(std::make_unique<LogRing>(ring_capacity_));
+        ring = rings_.back().get();
+        t.rings.emplace_back(instance_, ring);
+    }
+    t.last_instance = instance_;
+    t.last_ring = ring;
+    return *ring;
+}
+
+void AsyncLogger::push(const LogRecord& r) {
+    if (!file_) return;
+    LogRing& ring = local_ring();
+    if (ring.try_push(r)) return;
+    if (overflow_ == Overflow::Drop) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    while (!ring.try_push(r)) std::this_thread::yield();
+}
+
+void AsyncLogger::format(const LogRecord& r) {
+    if (r.fmt >= formats_.size()) return;
+    const std::vector<std::string>& pieces = formats_[r.fmt].pieces;
+    char num[32];
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        out_ += pieces[i];
+        if (i + 1 == pieces.size() || i >= r.nargs) continue;
+        std::to_chars_result res;
+        if (r.double_mask & (1u << i))  // %g with 6 digits == default ostream output
+            res = std::to_chars(num, num + sizeof(num), r.args[i].d, std::chars_format::general, 6);
+        else
+            res = std::to_chars(num, num + sizeof(num), r.args[i].i);
+        out_.append(num, res.ptr);
+    }
+}
+
+size_t AsyncLogger::drain_once() {
+    // Rings are never removed and live behind unique_ptr, so the pointers stay valid after
+    // the lock is dropped; a thread registering mid-pass is picked up on the next one.
+    // Formatting and fwrite run unlocked, so a new thread's first log call never waits
+    // on disk.
+    {
+        std::lock_guard<std::mutex> lock(rings_mu_);
+        drain_list_.clear();
+        for (auto& ring : rings_) drain_list_.push_back(ring.get());
+    }
+    size_t n = 0;
+    for (LogRing* ring : drain_list_)
+        n += ring->drain([this](const LogRecord& r) {
+            format(r);
+            if (out_.size() >= kFlushBytes) {
+                std::fwrite(out_.data(), 1, out_.size(), file_);
+                out_.clear();
+            }
+        });
+    return n;
+}
+
+void AsyncLogger::run() {
+    for (;;) {
+        // Read the flag before draining so the last pass sees every record pushed before close()
+        const bool stopping = stop_.load(std::memory_order_acquire);
+        const size_t n = drain_once();
+        if (n == 0 && !out_.empty()) {
+            std::fwrite(out_.data(), 1, out_.size(), file_);
+            out_.clear();
+        }
+        if (n == 0) {
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    std::fflush(file_);
+}
@@ -0,0 +1,136 @@
+//
+// Asynchronous event log. A log call copies a format id and its raw arguments (int64 or
+// double, no formatting) into the calling thread's ring buffer; a background thread
+// drains the rings, formats the records and writes them to the file in large batches.
+// The processing thread never touches iostreams or converts numbers to text.
+//
+// Formats are a table of strings with {} placeholders, fixed when the logger is built:
+//     static const char* const kFormats[] = {"[Market] Best Bid: {} x {}\n", ...};
+//     AsyncLogger log("output.log", kFormats);
+//     log.write(0, 100.15, 200);
+// Integral arguments print as integers and floating ones like operator<< on a default
+// ostream (6 significant digits). Records from one thread keep their order; records
+// from different threads are interleaved per drain pass, not by time.
+//
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct LogRecord {
+    static constexpr int kMaxArgs = 6;
+    uint16_t fmt;
+    uint8_t  nargs;
+    uint8_t  double_mask;   // bit i set: args[i] holds a double
+    uint32_t reserved;
+    union Arg { int64_t i; double d; } args[kMaxArgs];
+};
+static_assert(sizeof(LogRecord) == 56, "one record per ~cache line");
+
+// Single-producer / single-consumer ring of records (power-of-two capacity)
+class LogRing {
+public:
+    explicit LogRing(size_t capacity) : buf_(capacity), mask_(capacity - 1) {}
+
+    bool try_push(const LogRecord& r) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == buf_.size()) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == buf_.size()) return false;
+        }
+        buf_[head & mask_] = r;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: hands every available record to fn, returns how many
+    template <typename Fn>
+    size_t drain(Fn&& fn) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        for (size_t i = tail; i != head; ++i) fn(buf_[i & mask_]);
+        tail_.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+private:
+    std::vector<LogRecord> buf_;
+    const size_t mask_;
+    alignas(64) std::atomic<size_t> head_{0};  // producer writes
+    size_t tail_cache_ = 0;                    // producer's last view of tail_
+    alignas(64) std::atomic<size_t> tail_{0};  // consumer writes
+};
+
+class AsyncLogger {
+public:
+    enum class Overflow { Block, Drop };  // full ring: wait for the writer, or count and drop
+
+    template <size_t N>
+    AsyncLogger(const std::string& path, const char* const (&formats)[N],
+                 Overflow overflow = Overflow::Block, size_t ring_capacity = 1 << 16)
+        : AsyncLogger(path, formats, N, overflow, ring_capacity) {}
+    AsyncLogger(const std::string& path, const char* const* formats, size_t nformats,
+                Overflow overflow, size_t ring_capacity);
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+
+    template <typename... Args>
+    void write(uint16_t fmt, Args... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        LogRecord r;
+        r.fmt = fmt;
+        r.nargs = uint8_t(sizeof...(Args));
+        r.double_mask = 0;
+        r.reserved = 0;
+        int i = 0;
+        (encode(r, i++, args), ...);
+        push(r);
+    }
+
+    // Waits until everything logged so far is written, then closes the file
+    void close();
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    template <typename T>
+    static void encode(LogRecord& r, int i, T v) {
+        static_assert(std::is_arithmetic_v<T>, "log arguments are numbers");
+        if constexpr (std::is_floating_point_v<T>) {
+            r.args[i].d = double(v);
+            r.double_mask |= uint8_t(1u << i);
+        } else {
+            r.args[i].i = int64_t(v);
+        }
+    }
+
+    void push(const LogRecord& r);
+    LogRing& local_ring();
+    void run();
+    size_t drain_once();
+    void format(const LogRecord& r);
+
+    struct Format { std::vector<std::string> pieces; };  // text between placeholders
+    std::vector<Format> formats_;
+    std::FILE* file_ = nullptr;
+    Overflow overflow_;
+    size_t ring_capacity_;
+    std::mutex rings_mu_;
+    std::vector<std::unique_ptr<LogRing>> rings_;
+    std::vector<LogRing*> drain_list_;  // writer thread's copy of rings_ for one pass
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::string out_;  // writer thread's batch
+    std::thread writer_;
+    const uint64_t instance_;
+};
@@ -0,0 +1,175 @@
+//
+// Batch replay: many feed files (e.g. one per trading day), each replayed on its own
+// MarketSnapshot and DefaultStrategies harness, spread over a WorkStealingPool. Files
+// are submitted largest first, so the long ones start early and the small ones fill
+// the gaps by stealing. Each task writes only its own result slot; the summary is
+// merged on the calling thread once the pool is idle.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "binary_feed.h"
+#include "strategy.h"
+#include "work_stealing_pool.h"
+
+struct FileReplayResult {
+    std::string path;
+    bool ok = false;
+    std::string error;  // why ok is false
+    uint64_t bytes = 0;
+    uint64_t events = 0;
+    double seconds = 0;
+    TopOfBook last_top;
+    std::array<StrategyStats, DefaultStrategies::kCount> stats{};
+
+    // Positions are marked at the file's final mid (cash only if a side is empty)
+    int64_t mark_ticks() const {
+        return last_top.bid && last_top.ask ? (last_top.bid.ticks + last_top.ask.ticks) / 2 : 0;
+    }
+};
+
+// One file, start to finish, on the calling thread. No output.log: only the result.
+inline FileReplayResult replay_feed_file(const std::string& path) {
+    FileReplayResult r;
+    r.path = path;
+    std::error_code ec;
+    r.bytes = std::filesystem::file_size(path, ec);
+
+    MarketSnapshot book;
+    DefaultStrategies strategies = make_default_strategies();
+    NullOrderListener none;
+    const auto t0 = std::chrono::steady_clock::now();
+    r.ok = for_each_feed_event(path, [&](const FeedEvent& ev) {
+        ++r.events;
+        uint8_t changes = kNoChange;
+        if (ev.type == FeedType::BID)      changes = book.update_bid_ticks(ev.ticks, ev.quantity);
+        else if (ev.type == FeedType::ASK) changes = book.update_ask_ticks(ev.ticks, ev.quantity);
+        else strategies.on_execution(ev.order_id, ev.quantity, none);
+        strategies.on_top(book.top(), changes, none);
+    });
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!r.ok) r.error = "cannot read feed";
+    r.last_top = book.top();
+    strategies.for_each([&](size_t i, const char*, const OrderManager&, const StrategyStats& st) {
+        r.stats[i] = st;
+    });
+    return r;
+}
+
+// Directories expand to their regular files (sorted by name, dotfiles skipped); plain
+// paths are kept as given
+inline std::vector<std::string> list_feed_files(const std::vector<std::string>& args) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    for (const std::string& a : args) {
+        std::error_code ec;
+        if (!fs::is_directory(a, ec)) {
+            files.push_back(a);
+            continue;
+        }
+        std::vector<std::string> in_dir;
+        for (const fs::directory_entry& e : fs::directory_iterator(a, ec))
+            if (e.is_regular_file(ec) && e.path().filename().string()[0] != '.')
+                in_dir.push_back(e.path().string());
+        std::sort(in_dir.begin(), in_dir.end());
+        files.insert(files.end(), in_dir.begin(), in_dir.end());
+    }
+    return files;
+}
+
+struct BatchRun {
+    std::vector<FileReplayResult> files;  // in input order
+    double wall_seconds = 0;
+    unsigned threads = 0;
+    uint64_t steals = 0;
+};
+
+inline BatchRun replay_batch(const std::vector<std::string>& files, unsigned threads) {
+    BatchRun run;
+    run.files.resize(files.size());
+    std::vector<size_t> order(files.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::vector<uint64_t> size(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::error_code ec;
+        size[i] = std::filesystem::file_size(files[i], ec);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return size[a] > size[b]; });
+
+    const auto t0 = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(threads);
+        run.threads = pool.size();
+        for (size_t i : order)
+            pool.submit([&run, &files, i] {
+                // A throw (bad_alloc, OrderManager's length_error...) fails this file only
+                try {
+                    run.files[i] = replay_feed_file(files[i]);
+                } catch (const std::exception& e) {
+                    run.files[i] = FileReplayResult{};
+                    run.files[i].path = files[i];
+                    run.files[i].error = e.what();
+                }
+            });
+        pool.wait();
+        run.steals = pool.steals();
+    }
+    run.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return run;
+}
+
+// Per-file lines, then the merged totals
+inline void print_batch_summary(const BatchRun& run) {
+    const auto names = DefaultStrategies::names();
+    std::printf("%-40s %12s %8s %10s", "file", "events", "s", "M ev/s");
+    for (const char* n : names) std::printf(" %12s", n);
+    std::printf("\n");
+
+    uint64_t events = 0, bytes = 0, failed = 0;
+    double per_file = 0;
+    std::array<StrategyStats, DefaultStrategies::kCount> total{};
+    std::array<int64_t, DefaultStrategies::kCount> pnl{};
+    for (const FileReplayResult& f : run.files) {
+        if (!f.ok) {
+            ++failed;
+            std::printf("%-40s  failed: %s\n", f.path.c_str(), f.error.c_str());
+            continue;
+        }
+        events += f.events;
+        bytes += f.bytes;
+        per_file += f.seconds;
+        std::printf("%-40s %12" PRIu64 " %8.3f %10.2f", f.path.c_str(), f.events, f.seconds,
+                    f.seconds > 0 ? f.events / 1e6 / f.seconds : 0.0);
+        for (size_t s = 0; s < names.size(); ++s) {
+            const int64_t p = f.stats[s].pnl_ticks(f.mark_ticks());
+            std::printf(" %12.2f", ticks_to_price(p));
+            pnl[s] += p;
+            total[s].placed += f.stats[s].placed;
+            total[s].cancelled += f.stats[s].cancelled;
+            total[s].fills += f.stats[s].fills;
+        }
+        std::printf("\n");
+    }
+
+    std::printf("\n%-12s %10s %10s %10s %12s\n", "strategy", "placed", "cancelled", "fills", "pnl");
+    for (size_t s = 0; s < names.size(); ++s)
+        std::printf("%-12s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %12.2f\n", names[s],
+                    total[s].placed, total[s].cancelled, total[s].fills, ticks_to_price(pnl[s]));
+
+    std::printf("\n%zu files (%" PRIu64 " failed), %" PRIu64 " events, %.1f MB on %u threads\n",
+                run.files.size(), failed, events, bytes / 1048576.0, run.threads);
+    std::printf("wall %.3f s, %.2f M events/s, %.1f MB/s; per-file times sum to %.3f s (%.2fx), %" PRIu64 " steals\n",
+                run.wall_seconds, events / 1e6 / run.wall_seconds, bytes / 1048576.0 / run.wall_seconds,
+                per_file, per_file / run.wall_seconds, run.steals);
+}
@@ -0,0 +1,635 @@
+//
+// Benchmarks for the local order book infrastructure.
+//
+//   bench parse [MB] [file]    text feed parsing: load_feed vs mmap + FeedCursor
+//   bench binary [MB] [file]   text -> binary conversion, then replay of both formats
+//   bench snapshot [MB] [file] map-based vs tick-ladder MarketSnapshot on a replayed feed
+//   bench orders [N]           map + make_unique vs slab OrderManager, N orders
+//   bench log [MB] [file]      event replay with no log, an ofstream log and the async log
+//   bench strategies [MB] [file] three strategies in one pass vs one feed pass per strategy
+//   bench batch [files] [MB] [threads] replay of many day files, 1 thread vs the work-stealing pool
+//
+// Build: g++ -std=c++17 -O2 bench.cpp market_snapshot.cpp order_manager.cpp async_log.cpp -o bench -pthread
+//
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "async_log.h"
+#include "batch_replay.h"
+#include "binary_feed.h"
+#include "market_snapshot.h"
+#include "order_manager.h"
+#include "strategy.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+static double seconds_since(bench_clock::time_point t0) {
+    return std::chrono::duration<double>(bench_clock::now() - t0).count();
+}
+
+//=============================
+// Synthetic feed
+// Random walk around 100.00 in 0.01 ticks: book updates within 10 ticks of mid
+// (15% deletes), 5% executions against ids 1..1000, a comment line now and then.
+// Bids are quoted below mid and asks above it, and when mid steps a tick the one level
+// that would now cross it is deleted, so the book is never crossed or locked. Levels
+// the walk leaves behind stay in the book as depth.
+// Deterministic for a given seed, so a smaller file is a prefix of a larger one.
+//=============================
+static char* put_uint(char* p, uint64_t v) {
+    char tmp[20];
+    int n = 0;
+    do { tmp[n++] = char('0' + v % 10); v /= 10; } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static char* put_level(char* p, bool bid, int64_t px, uint64_t q) {
+    std::memcpy(p, bid ? "BID " : "ASK ", 4); p += 4;
+    p = put_uint(p, uint64_t(px / 100)); *p++ = '.';
+    *p++ = char('0' + px % 100 / 10); *p++ = char('0' + px % 10); *p++ = ' ';
+    p = put_uint(p, q); *p++ = '\n';
+    return p;
+}
+
+static bool write_synthetic_feed(const std::string& path, uint64_t bytes, uint64_t seed = 7) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::mt19937_64 rng(seed);
+    std::vector<char> buf(1 << 20);
+    int64_t mid = 10000; // cents
+    uint64_t written = 0, n = 0;
+    while (written < bytes) {
+        char* p = buf.data();
+        char* const limit = buf.data() + buf.size() - 64;
+        while (p < limit && written + uint64_t(p - buf.data()) < bytes) {
+            const uint64_t r = rng();
+            if ((++n & 15) == 0) {
+                const int64_t step = int64_t(r % 3) - 1;
+                mid += step;
+                if (step > 0) p = put_level(p, false, mid, 0);  // old best-possible ask
+                if (step < 0) p = put_level(p, true, mid, 0);   // old best-possible bid
+            }
+            const unsigned kind = unsigned(r >> 8) % 1000;
+            if (kind == 0) {
+                const char c[] = "# synthetic\n";
+                std::memcpy(p, c, sizeof(c) - 1);
+                p += sizeof(c) - 1;
+            } else if (kind < 50) {
+                std::memcpy(p, "EXECUTION ", 10); p += 10;
+                p = put_uint(p, 1 + (r >> 20) % 1000); *p++ = ' ';
+                p = put_uint(p, 1 + (r >> 32) % 100);  *p++ = '\n';
+            } else {
+                const bool bid = (r >> 18) & 1;
+                const int64_t off = int64_t((r >> 24) % 10);
+                const int64_t px = bid ? mid - 1 - off : mid + 1 + off;
+                const uint64_t q = ((r >> 40) % 100) < 15 ? 0 : 1 + (r >> 48) % 500;
+                p = put_level(p, bid, px, q);
+            }
+        }
+        const size_t len = size_t(p - buf.data());
+        if (std::fwrite(buf.data(), 1, len, f) != len) { std::fclose(f); return false; }
+        written += len;
+    }
+    return std::fclose(f) == 0;
+}
+
+static uint64_t file_size(const std::string& path) {
+    MappedFile m;
+    return m.open(path) ? m.size() : 0;
+}
+
+// Writes the synthetic feed unless a big enough one is already there
+static bool ensure_synthetic_feed(const std::string& path, uint64_t bytes) {
+    if (file_size(path) >= bytes) return true;
+    std::printf("writing %s (%.0f MB)...\n", path.c_str(), bytes / 1e6);
+    if (write_synthetic_feed(path, bytes)) return true;
+    std::fprintf(stderr, "could not write %s\n", path.c_str());
+    return false;
+}
+
+// Order-independent summary of an event stream, to check two parsers agree
+struct FeedDigest {
+    uint64_t events = 0, bids = 0, asks = 0, execs = 0;
+    int64_t qty = 0, cents = 0, ids = 0;
+
+    void add(const FeedEvent& ev) {
+        ++events;
+        qty += ev.quantity;
+        switch (ev.type) {
+            case FeedType::BID:       ++bids;  cents += std::llround(ev.price * 100.0); break;
+            case FeedType::ASK:       ++asks;  cents += std::llround(ev.price * 100.0); break;
+            case FeedType::EXECUTION: ++execs; ids += ev.order_id; break;
+            default: break;
+        }
+    }
+    bool operator==(const FeedDigest& o) const {
+        return events == o.events && bids == o.bids && asks == o.asks && execs == o.execs &&
+               qty == o.qty && cents == o.cents && ids == o.ids;
+    }
+};
+
+static void print_rate(const char* name, uint64_t bytes, uint64_t events, double s) {
+    std::printf("%-26s %10.1f MB  %12" PRIu64 " events  %8.3f s  %9.1f MB/s  %7.2f M events/s\n",
+                name, bytes / 1e6, events, s, bytes / 1e6 / s, events / 1e6 / s);
+}
+
+//=============================
+// parse: getline + istringstream into a vector (load_feed) vs mmap + hand-written parser
+// with a per-event callback. load_feed holds the whole feed in memory, so it runs on a
+// capped prefix of the synthetic feed; the mmap parser runs on both.
+//=============================
+static int bench_parse(int argc, char** argv) {
+    const uint64_t mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2048;
+    const std::string path = argc > 3 ? argv[3] : "synthetic_feed.txt";
+    const uint64_t bytes = mb << 20;
+    const uint64_t small_bytes = std::min<uint64_t>(bytes, 256ull << 20);
+    const std::string small_path = path + ".head";
+
+    if (!ensure_synthetic_feed(path, bytes) || !ensure_synthetic_feed(small_path, small_bytes)) return 1;
+    const uint64_t size = file_size(path), small_size = file_size(small_path);
+    std::printf("files are in the page cache (just written or reused): parser cost, not disk\n\n");
+
+    FeedDigest legacy;
+    auto t0 = bench_clock::now();
+    {
+        const std::vector<FeedEvent> events = load_feed(small_path);
+        for (const FeedEvent& ev : events) legacy.add(ev);
+    }
+    print_rate("load_feed (head)", small_size, legacy.events, seconds_since(t0));
+
+    FeedDigest mapped_small;
+    t0 = bench_clock::now();
+    for_each_event(small_path, [&](const FeedEvent& ev) { mapped_small.add(ev); });
+    print_rate("mmap + FeedCursor (head)", small_size, mapped_small.events, seconds_since(t0));
+
+    FeedDigest mapped;
+    t0 = bench_clock::now();
+    for_each_event(path, [&](const FeedEvent& ev) { mapped.add(ev); });
+    print_rate("mmap + FeedCursor (full)", size, mapped.events, seconds_since(t0));
+
+    const bool ok = legacy == mapped_small;
+    std::printf("\nhead digests %s (events=%" PRIu64 " bids=%" PRIu64 " asks=%" PRIu64 " execs=%" PRIu64 ")\n",
+                ok ? "match" : "MISMATCH", legacy.events, legacy.bids, legacy.asks, legacy.execs);
+    return ok ? 0 : 1;
+}
+
+//=============================
+// binary: convert the synthetic text feed once, then replay each format through
+// for_each_feed_event (format picked from the file's magic, as main does)
+//=============================
+static int bench_binary(int argc, char** argv) {
+    const uint64_t mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2048;
+    const std::string path = argc > 3 ? argv[3] : "synthetic_feed.txt";
+    const std::string bin_path = path + ".bin";
+    if (!ensure_synthetic_feed(path, mb << 20)) return 1;
+
+    uint64_t records = 0;
+    auto t0 = bench_clock::now();
+    if (!convert_text_feed(path, bin_path, &records)) return 1;
+    const double convert_s = seconds_since(t0);
+    const uint64_t text_size = file_size(path), bin_size = file_size(bin_path);
+    std::printf("converted %" PRIu64 " records in %.3f s: %.1f MB text -> %.1f MB binary\n\n",
+                records, convert_s, text_size / 1e6, bin_size / 1e6);
+
+    FeedDigest text, bin;
+    t0 = bench_clock::now();
+    for_each_feed_event(path, [&](const FeedEvent& ev) { text.add(ev); });
+    const double text_s = seconds_since(t0);
+    t0 = bench_clock::now();
+    for_each_feed_event(bin_path, [&](const FeedEvent& ev) { bin.add(ev); });
+    const double bin_s = seconds_since(t0);
+
+    print_rate("text replay", text_size, text.events, text_s);
+    print_rate("binary replay", bin_size, bin.events, bin_s);
+    const bool ok = text == bin && bin.events == records;
+    std::printf("\nbinary replay %.1fx faster in events/s; digests %s\n", text_s / bin_s,
+                ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+// Replays the first `bytes` of the synthetic feed into memory (parsing is not timed)
+static bool load_events(const std::string& path, uint64_t bytes, std::vector<FeedEvent>& events) {
+    if (!ensure_synthetic_feed(path, bytes)) return false;
+    MappedFile file;
+    if (!file.open(path)) return false;
+    const char* end = file.data() + std::min<uint64_t>(bytes, file.size());
+    while (end > file.data() && end[-1] != '\n') --end; // whole lines only
+    for_each_event(file.data(), end, [&](const FeedEvent& ev) { events.push_back(ev); });
+    return true;
+}
+
+//=============================
+// snapshot: every book event is applied and then both best levels are read, as the
+// main loop does. The checksum folds the best ticks/sizes after each event, so both
+// books must agree on the whole top-of-book history.
+//=============================
+// Each book takes the event in its native form: doubles for the map, parse-time ticks
+// for the ladder
+static void apply(MapMarketSnapshot& book, const FeedEvent& ev) {
+    if (ev.type == FeedType::BID) book.update_bid(ev.price, ev.quantity);
+    else                          book.update_ask(ev.price, ev.quantity);
+}
+static void apply(MarketSnapshot& book, const FeedEvent& ev) {
+    if (ev.type == FeedType::BID) book.update_bid_ticks(ev.ticks, ev.quantity);
+    else                          book.update_ask_ticks(ev.ticks, ev.quantity);
+}
+
+template <typename Book, typename BestBid, typename BestAsk>
+static double replay_book(const std::vector<FeedEvent>& events, BestBid best_bid, BestAsk best_ask,
+                          uint64_t& checksum) {
+    Book book;
+    uint64_t h = 0;
+    const auto t0 = bench_clock::now();
+    for (const FeedEvent& ev : events) {
+        if (ev.type == FeedType::EXECUTION) continue;
+        apply(book, ev);
+        const BookLevel b = best_bid(book), a = best_ask(book);
+        h = h * 1099511628211ull + uint64_t(b.ticks * 1000003 + b.quantity);
+        h = h * 1099511628211ull + uint64_t(a.ticks * 1000003 + a.quantity);
+    }
+    const double s = seconds_since(t0);
+    checksum = h;
+    return s;
+}
+
+// A consumer that does real work per top: microprice, size imbalance and spread in bps
+// (three divisions), rounded and packed into one word. Pure in the top, so both rows
+// below must fold the same history.
+static uint64_t top_signal(const BookLevel& b, const BookLevel& a) {
+    if (!b || !a) return 0;
+    const double bq = b.quantity, aq = a.quantity;
+    const double micro = (double(b.ticks) * aq + double(a.ticks) * bq) / (bq + aq);
+    const double imb = (bq - aq) / (bq + aq);
+    const double spread_bps = 2e4 * double(a.ticks - b.ticks) / double(a.ticks + b.ticks);
+    return uint64_t(std::llround(micro * 100)) ^ (uint64_t(std::llround(imb * 1e4)) << 24) ^
+           (uint64_t(std::llround(spread_bps * 100)) << 44);
+}
+
+// The consumer after every update (no flags: the caller cannot tell what changed), or
+// only when the update reports a TopChange, reusing the last result otherwise
+template <bool OnFlags>
+static double replay_top_signal(const std::vector<FeedEvent>& events, uint64_t& checksum,
+                                uint64_t& computed) {
+    MarketSnapshot book;
+    uint64_t sig = 0, h = 0, n = 0;
+    const auto t0 = bench_clock::now();
+    for (const FeedEvent& ev : events) {
+        if (ev.type == FeedType::EXECUTION) continue;
+        const uint8_t changes = ev.type == FeedType::BID ? book.update_bid_ticks(ev.ticks, ev.quantity)
+                                                         : book.update_ask_ticks(ev.ticks, ev.quantity);
+        if (!OnFlags || changes) {
+            sig = top_signal(book.get_best_bid(), book.get_best_ask());
+            ++n;
+        }
+        h = h * 1099511628211ull + sig;
+    }
+    const double s = seconds_since(t0);
+    checksum = h;
+    computed = n;
+    return s;
+}
+
+static int bench_snapshot(int argc, char** argv) {
+    const uint64_t mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+    const std::string path = argc > 3 ? argv[3] : "synthetic_feed.txt";
+    std::vector<FeedEvent> events;
+    if (!load_events(path, mb << 20, events)) return 1;
+    uint64_t updates = 0;
+    for (const FeedEvent& ev : events) updates += ev.type != FeedType::EXECUTION;
+
+    auto level_of = [](const PriceLevel* p) {
+        return p ? BookLevel{price_to_ticks(p->price), p->quantity} : BookLevel{};
+    };
+    uint64_t map_sum = 0, tick_sum = 0;
+    const double map_s = replay_book<MapMarketSnapshot>(events,
+        [&](const MapMarketSnapshot& b) { return level_of(b.get_best_bid()); },
+        [&](const MapMarketSnapshot& b) { return level_of(b.get_best_ask()); }, map_sum);
+    const double tick_s = replay_book<MarketSnapshot>(events,
+        [](const MarketSnapshot& b) { return b.get_best_bid(); },
+        [](const MarketSnapshot& b) { return b.get_best_ask(); }, tick_sum);
+    uint64_t every_sum = 0, every_n = 0, flag_sum = 0, flagged = 0;
+    const double every_s = replay_top_signal<false>(events, every_sum, every_n);
+    const double flag_s = replay_top_signal<true>(events, flag_sum, flagged);
+
+    std::printf("%" PRIu64 " book updates, best bid/ask read after each\n\n", updates);
+    std::printf("%-28s %8.3f s  %7.1f ns/update  %7.2f M updates/s\n", "map<double, unique_ptr>",
+                map_s, map_s * 1e9 / updates, updates / 1e6 / map_s);
+    std::printf("%-28s %8.3f s  %7.1f ns/update  %7.2f M updates/s\n", "tick ladder",
+                tick_s, tick_s * 1e9 / updates, updates / 1e6 / tick_s);
+    std::printf("\nconsumer computing a signal from the top (microprice, imbalance, spread)\n");
+    std::printf("%-28s %8.3f s  %7.1f ns/update  %7.2f M updates/s\n", "tick ladder + every update",
+                every_s, every_s * 1e9 / updates, updates / 1e6 / every_s);
+    std::printf("%-28s %8.3f s  %7.1f ns/update  %7.2f M updates/s\n", "tick ladder + on flags",
+                flag_s, flag_s * 1e9 / updates, updates / 1e6 / flag_s);
+    std::printf("%" PRIu64 " (%.1f%%) of updates changed the top of book\n", flagged, 100.0 * flagged / updates);
+    const bool ok = map_sum == tick_sum && every_sum == flag_sum && every_n == updates;
+    std::printf("\ntick ladder %.1fx faster than the map; flags %.2fx faster for the consumer; histories %s\n",
+                map_s / tick_s, every_s / flag_s, ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+//=============================
+// orders: two workloads per manager
+//   bulk  : place N orders, then fill each in two halves (N live at the peak)
+//   churn : 1024 live orders; each step places one and retires the oldest
+//           (full fill, every 8th cancelled), so slots are recycled constantly
+// Stale ids are replayed at the end: fills for finished orders must be ignored.
+//=============================
+struct OrderRun { double bulk_s, churn_s; uint64_t digest; };
+
+template <typename Manager>
+static OrderRun run_orders(size_t n) {
+    OrderRun r{};
+    uint64_t h = 0;
+    auto mix = [&](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+    {
+        Manager om;
+        std::vector<OrderId> ids(n);
+        const auto t0 = bench_clock::now();
+        for (size_t i = 0; i < n; ++i)
+            ids[i] = om.place_order(i & 1 ? Side::Buy : Side::Sell, 100.0 + double(i % 100) * 0.01, 100);
+        for (size_t i = 0; i < n; ++i) om.handle_fill(ids[i], 50);
+        for (size_t i = 0; i < n; ++i) {
+            const MyOrder* o = om.get(ids[i]);
+            mix(o ? uint64_t(o->filled) : 0);
+            om.handle_fill(ids[i], 50);
+        }
+        r.bulk_s = seconds_since(t0);
+        for (size_t i = 0; i < n; i += 1024) om.handle_fill(ids[i], 50); // stale
+        mix(om.active());
+    }
+    {
+        Manager om;
+        const size_t window = 1024;
+        std::vector<OrderId> ring(window);
+        size_t head = 0;
+        const auto t0 = bench_clock::now();
+        for (size_t i = 0; i < window; ++i) ring[i] = om.place_order(Side::Buy, 100.0, 10);
+        const OrderId first_id = ring[0]; // its slot is reused many times below
+        for (size_t i = 0; i < n; ++i) {
+            const OrderId old = ring[head];
+            if (i % 8 == 0) om.cancel(old);
+            else            om.handle_fill(old, 10);
+            ring[head] = om.place_order(Side::Sell, 100.0 + double(i % 50) * 0.01, 10);
+            head = (head + 1) % window;
+        }
+        r.churn_s = seconds_since(t0);
+        om.handle_fill(first_id, 10); // stale: must not complete the slot's current order
+        mix(om.active());
+    }
+    r.digest = h;
+    return r;
+}
+
+static int bench_orders(int argc, char** argv) {
+    const size_t n = argc > 2 ? size_t(std::strtoull(argv[2], nullptr, 10)) : 4000000;
+    const OrderRun m = run_orders<MapOrderManager>(n);
+    const OrderRun s = run_orders<OrderManager>(n);
+    // bulk: n places + 2n fills + n gets; churn: n retires + n places
+    const double bulk_ops = 4.0 * double(n), churn_ops = 2.0 * double(n);
+    std::printf("%zu orders\n\n%-24s %12s %12s %12s %12s\n", n, "", "bulk (s)", "ns/op",
+                "churn (s)", "ns/op");
+    std::printf("%-24s %12.3f %12.1f %12.3f %12.1f\n", "map + make_unique",
+                m.bulk_s, m.bulk_s * 1e9 / bulk_ops, m.churn_s, m.churn_s * 1e9 / churn_ops);
+    std::printf("%-24s %12.3f %12.1f %12.3f %12.1f\n", "slab + free list",
+                s.bulk_s, s.bulk_s * 1e9 / bulk_ops, s.churn_s, s.churn_s * 1e9 / churn_ops);
+    const bool ok = m.digest == s.digest;
+    std::printf("\nslab %.1fx (bulk) / %.1fx (churn) faster; results %s\n",
+                m.bulk_s / s.bulk_s, m.churn_s / s.churn_s, ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+//=============================
+// log: the replay loop writes one line per event (the event plus the top of book after
+// it) through each sink. The ofstream sink formats on the processing thread; the async
+// sink only copies a record. "loop" is the processing time, "until written" also waits
+// for the file to be complete. Both logs must be byte-identical.
+//=============================
+enum BenchLogFmt : uint16_t { kLogBid, kLogAsk, kLogExec };
+static const char* const kBenchLogFormats[] = {
+    "[Book] BID {} x {} | best {} x {} / {} x {}\n",
+    "[Book] ASK {} x {} | best {} x {} / {} x {}\n",
+    "[Execution] Order {} filled: {}\n",
+};
+
+struct NoLog {
+    void event(const FeedEvent&, const BookLevel&, const BookLevel&) {}
+    void close() {}
+};
+
+struct StreamLog {
+    std::ofstream out;
+    explicit StreamLog(const std::string& path) : out(path, std::ios::binary) {}
+    void event(const FeedEvent& ev, const BookLevel& b, const BookLevel& a) {
+        if (ev.type == FeedType::EXECUTION) {
+            out << "[Execution] Order " << ev.order_id << " filled: " << ev.quantity << "\n";
+            return;
+        }
+        out << (ev.type == FeedType::BID ? "[Book] BID " : "[Book] ASK ") << ev.price << " x "
+            << ev.quantity << " | best " << b.price() << " x " << b.quantity << " / "
+            << a.price() << " x " << a.quantity << "\n";
+    }
+    void close() { out.close(); }
+};
+
+struct AsyncSink {
+    AsyncLogger log;
+    AsyncSink(const std::string& path, AsyncLogger::Overflow overflow, size_t ring)
+        : log(path, kBenchLogFormats, overflow, ring) {}
+    void event(const FeedEvent& ev, const BookLevel& b, const BookLevel& a) {
+        if (ev.type == FeedType::EXECUTION)
+            log.write(kLogExec, ev.order_id, ev.quantity);
+        else
+            log.write(ev.type == FeedType::BID ? kLogBid : kLogAsk, ev.price, ev.quantity,
+                      b.price(), b.quantity, a.price(), a.quantity);
+    }
+    void close() { log.close(); }
+};
+
+struct LogRun { double loop_s, total_s; };
+
+template <typename Sink>
+static LogRun replay_logged(const std::vector<FeedEvent>& events, Sink& sink) {
+    MarketSnapshot book;
+    const auto t0 = bench_clock::now();
+    for (const FeedEvent& ev : events) {
+        if (ev.type == FeedType::BID)      book.update_bid_ticks(ev.ticks, ev.quantity);
+        else if (ev.type == FeedType::ASK) book.update_ask_ticks(ev.ticks, ev.quantity);
+        sink.event(ev, book.get_best_bid(), book.get_best_ask());
+    }
+    const double loop_s = seconds_since(t0);
+    sink.close();
+    return {loop_s, seconds_since(t0)};
+}
+
+static bool same_file(const std::string& a, const std::string& b) {
+    MappedFile fa(a), fb(b);
+    return fa.is_open() && fb.is_open() && fa.size() == fb.size() &&
+           std::memcmp(fa.data(), fb.data(), fa.size()) == 0;
+}
+
+static int bench_log(int argc, char** argv) {
+    const uint64_t mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 128;
+    const std::string path = argc > 3 ? argv[3] : "synthetic_feed.txt";
+    std::vector<FeedEvent> events;
+    if (!load_events(path, mb << 20, events)) return 1;
+    const uint64_t n = events.size();
+
+    auto row = [&](const char* name, const LogRun& r) {
+        std::printf("%-26s %8.3f s  %7.1f ns/event  %7.2f M events/s  %8.3f s\n", name,
+                    r.loop_s, r.loop_s * 1e9 / n, n / 1e6 / r.loop_s, r.total_s);
+    };
+    std::printf("%" PRIu64 " events, one log line each\n\n%-26s %10s %17s %19s %10s\n", n, "",
+                "loop", "", "", "until written");
+    NoLog none;
+    row("no logging", replay_logged(events, none));
+    StreamLog sync("bench_log_ofstream.txt");
+    const LogRun sr = replay_logged(events, sync);
+    row("ofstream (formats inline)", sr);
+    AsyncSink async("bench_log_async.txt", AsyncLogger::Overflow::Block, 1 << 16);
+    const LogRun ar = replay_logged(events, async);
+    row("async, block when full", ar);
+    AsyncSink lossy("bench_log_drop.txt", AsyncLogger::Overflow::Drop, 1 << 10);
+    row("async, drop (1K ring)", replay_logged(events, lossy));
+    std::printf("%26s %" PRIu64 " records dropped\n", "", lossy.log.dropped());
+
+    const bool ok = same_file("bench_log_ofstream.txt", "bench_log_async.txt");
+    std::printf("\nasync loop %.1fx faster than ofstream; logs %s\n",
+                sr.loop_s / ar.loop_s, ok ? "identical" : "DIFFER");
+    return ok ? 0 : 1;
+}
+
+//=============================
+// strategies: the default set run by one harness over a single parse of the feed,
+// against one parse + replay per strategy (what running each strategy separately costs).
+// Parsing is timed here since it is the work the single pass saves.
+//=============================
+template <typename Harness>
+static double replay_strategies(const char* begin, const char* end, Harness& harness) {
+    MarketSnapshot book;
+    NullOrderListener none;
+    const auto t0 = bench_clock::now();
+    for_each_event(begin, end, [&](const FeedEvent& ev) {
+        uint8_t changes = kNoChange;
+        if (ev.type == FeedType::BID)      changes = book.update_bid_ticks(ev.ticks, ev.quantity);
+        else if (ev.type == FeedType::ASK) changes = book.update_ask_ticks(ev.ticks, ev.quantity);
+        else harness.on_execution(ev.order_id, ev.quantity, none);
+        harness.on_top(book.top(), changes, none);
+    });
+    return seconds_since(t0);
+}
+
+static int bench_strategies(int argc, char** argv) {
+    const uint64_t mb = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+    const std::string path = argc > 3 ? argv[3] : "synthetic_feed.txt";
+    if (!ensure_synthetic_feed(path, mb << 20)) return 1;
+    MappedFile file;
+    if (!file.open(path)) return 1;
+    const char* end = file.data() + std::min<uint64_t>(mb << 20, file.size());
+    while (end > file.data() && end[-1] != '\n') --end;
+    const uint64_t bytes = uint64_t(end - file.data());
+
+    DefaultStrategies all = make_default_strategies();
+    const double one_s = replay_strategies(file.data(), end, all);
+
+    // The same three, one harness (and one feed pass) each
+    DefaultStrategies proto = make_default_strategies();
+    StrategyHarness<ThresholdSell> t(proto.strategy<0>());
+    StrategyHarness<SpreadCapture> sp(proto.strategy<1>());
+    StrategyHarness<Imbalance> im(proto.strategy<2>());
+    const double sep_s = replay_strategies(file.data(), end, t) +
+                         replay_strategies(file.data(), end, sp) +
+                         replay_strategies(file.data(), end, im);
+
+    std::vector<StrategyStats> joint, alone;
+    all.for_each([&](size_t, const char*, const OrderManager&, const StrategyStats& st) { joint.push_back(st); });
+    auto collect = [&](size_t, const char*, const OrderManager&, const StrategyStats& st) { alone.push_back(st); };
+    t.for_each(collect);
+    sp.for_each(collect);
+    im.for_each(collect);
+
+    std::printf("%.0f MB of feed\n\n", bytes / 1048576.0);
+    std::printf("%-28s %8.3f s  %7.1f MB/s\n", "one pass, 3 strategies", one_s, bytes / 1048576.0 / one_s);
+    std::printf("%-28s %8.3f s  %7.1f MB/s\n", "3 passes, 1 strategy each", sep_s, 3 * bytes / 1048576.0 / sep_s);
+    const auto names = DefaultStrategies::names();
+    std::printf("\n%-12s %10s %10s %10s %10s\n", "strategy", "placed", "cancelled", "fills", "position");
+    for (size_t i = 0; i < joint.size(); ++i)
+        std::printf("%-12s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRId64 "\n", names[i],
+                    joint[i].placed, joint[i].cancelled, joint[i].fills, joint[i].position);
+    const bool ok = joint == alone;
+    std::printf("\none pass %.1fx faster; per-strategy results %s\n", sep_s / one_s,
+                ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+//=============================
+// batch: `files` synthetic day files (different seeds, sizes MB/2 .. 2*MB) under
+// synthetic_days/, replayed once on a single thread and once on the pool. Every
+// file's result must be identical either way.
+//=============================
+static int bench_batch(int argc, char** argv) {
+    const size_t nfiles = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    const uint64_t mb = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 32;
+    const unsigned threads = argc > 4 ? unsigned(std::strtoul(argv[4], nullptr, 10))
+                                      : std::max(1u, std::thread::hardware_concurrency());
+    std::filesystem::create_directories("synthetic_days");
+    std::vector<std::string> files;
+    for (size_t i = 0; i < nfiles; ++i) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "synthetic_days/day_%03zu.txt", i);
+        const uint64_t bytes = (mb << 20) * (1 + i % 4) / 2;
+        if (file_size(name) < bytes && !write_synthetic_feed(name, bytes, 100 + i)) {
+            std::fprintf(stderr, "cannot write %s\n", name);
+            return 1;
+        }
+        files.push_back(name);
+    }
+
+    replay_batch(files, 1);  // untimed: pages the files in and warms the allocator
+    const BatchRun serial = replay_batch(files, 1);
+    const BatchRun pooled = replay_batch(files, threads);
+    print_batch_summary(pooled);
+
+    bool ok = true;
+    for (size_t i = 0; i < files.size(); ++i)
+        ok = ok && serial.files[i].ok && pooled.files[i].ok &&
+             serial.files[i].events == pooled.files[i].events &&
+             serial.files[i].stats == pooled.files[i].stats;
+    std::printf("\n1 thread %.3f s, %u threads %.3f s: %.2fx; per-file results %s\n",
+                serial.wall_seconds, pooled.threads, pooled.wall_seconds,
+                serial.wall_seconds / pooled.wall_seconds, ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+static int usage() {
+    std::fprintf(stderr,
+                 "usage: bench parse  [MB=2048] [file=synthetic_feed.txt]\n"
+                 "       bench binary [MB=2048] [file=synthetic_feed.txt]\n"
+                 "       bench snapshot [MB=256] [file=synthetic_feed.txt]\n"
+                 "       bench orders [N=4000000]\n"
+                 "       bench log [MB=128] [file=synthetic_feed.txt]\n"
+                 "       bench strategies [MB=256] [file=synthetic_feed.txt]\n"
+                 "       bench batch [files=16] [MB=32] [threads=all cores]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    const std::string cmd = argv[1];
+    if (cmd == "parse") return bench_parse(argc, argv);
+    if (cmd == "binary") return bench_binary(argc, argv);
+    if (cmd == "snapshot") return bench_snapshot(argc, argv);
+    if (cmd == "orders") return bench_orders(argc, argv);
+    if (cmd == "log") return bench_log(argc, argv);
+    if (cmd == "strategies") return bench_strategies(argc, argv);
+    if (cmd == "batch") return bench_batch(argc, argv);
+    return usage();
+}
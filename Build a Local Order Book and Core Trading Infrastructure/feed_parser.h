@@ -1,11 +1,21 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// Prices are quoted in 0.01 ticks; the book and strategies work in integer ticks
+constexpr int64_t kTicksPerUnit = 100;
+inline int64_t price_to_ticks(double price) { return std::llround(price * kTicksPerUnit); }
+inline double ticks_to_price(int64_t ticks) { return double(ticks) / kTicksPerUnit; }
+
+// Order ids are 64-bit handles (see OrderManager)
+using OrderId = int64_t;
+
 enum class FeedType {
     BID,
     ASK,
@@ -17,7 +27,8 @@ struct FeedEvent {
     FeedType type = FeedType::UNKNOWN;
     double price = 0.0;
     int quantity = 0;
-    int order_id = -1; // used for EXECUTION only
+    OrderId order_id = -1; // used for EXECUTION only
+    int64_t ticks = 0; // price in ticks, filled in by the parsers
 
     // Debug print
     void print() const {
@@ -37,7 +48,7 @@ struct FeedEvent {
     }
 };
 
-std::vector<FeedEvent> load_feed(const std::string& filename) {
+inline std::vector<FeedEvent> load_feed(const std::string& filename) {
     std::ifstream file(filename);
     std::vector<FeedEvent> events;
 
@@ -59,16 +70,16 @@ std::vector<FeedEvent> load_feed(const std::string& filename) {
             double price;
             int qty;
             if (iss >> price >> qty) {
-                events.push_back({FeedType::BID, price, qty});
+                events.push_back({FeedType::BID, price, qty, -1, price_to_ticks(price)});
             }
         } else if (type == "ASK") {
             double price;
             int qty;
             if (iss >> price >> qty) {
-                events.push_back({FeedType::ASK, price, qty});
+                events.push_back({FeedType::ASK, price, qty, -1, price_to_ticks(price)});
             }
         } else if (type == "EXECUTION") {
-            int order_id;
+            OrderId order_id;
             int filled;
             if (iss >> order_id >> filled) {
                 events.push_back({FeedType::EXECUTION, 0.0, filled, order_id});
@@ -1,89 +1,179 @@
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
-#include <unordered_map>
+#include <string>
+#include <vector>
 #include "market_snapshot.h"
 #include "order_manager.h"
-#include "feed_parser.h"
+#include "binary_feed.h"
+#include "async_log.h"
+#include "strategy.h"
+#include "batch_replay.h"
 
-static void log_best_changes(std::ofstream& log,
-                             const PriceLevel* prevBid, const PriceLevel* prevAsk,
-                             const PriceLevel* curBid,  const PriceLevel* curAsk)
+// output.log lines; the logger formats them on its own thread. The fixed lines come
+// first, then kPerStrategy lines for each strategy with its name filled in.
+enum LogFmt : uint16_t { kBestBid, kBestBidRemoved, kBestAsk, kNewAsk, kBestAskRemoved,
+                         kExecution, kStrategyFormats };
+enum StrategyFmt : uint16_t { kPlaceBuy, kPlaceSell, kCancelled, kPartial, kCompleted, kPerStrategy };
+static const char* const kLogFormats[] = {
+    "[Market] Best Bid: {} x {}\n",
+    "[Market] Best Bid: {} removed\n",
+    "[Market] Best Ask: {} x {}\n",
+    "[Market] New Ask: {} x {}\n",
+    "[Market] Best Ask: {} removed\n",
+    "[Execution] Order {} filled: {}\n",
+};
+static const char* const kStrategyLogFormats[kPerStrategy] = {
+    "[Strategy %s] Placing BUY order at {} x {} (ID = {})\n",
+    "[Strategy %s] Placing SELL order at {} x {} (ID = {})\n",
+    "[Order %s] Order {} cancelled ({} / {} filled)\n",
+    "[Order %s] Order {} partially filled: {} / {}\n",
+    "[Order %s] Order {} completed ({} / {}) and removed\n",
+};
+
+template <size_t N>
+static std::vector<std::string> log_formats(const std::array<const char*, N>& strategy_names) {
+    std::vector<std::string> formats(std::begin(kLogFormats), std::end(kLogFormats));
+    char line[256];
+    for (const char* name : strategy_names)
+        for (const char* f : kStrategyLogFormats) {
+            std::snprintf(line, sizeof(line), f, name);
+            formats.emplace_back(line);
+        }
+    return formats;
+}
+
+// `changes` are the TopChange flags of the update; prev* is the top before it
+static void log_best_changes(AsyncLogger& log, uint8_t changes,
+                             const BookLevel& prevBid, const BookLevel& prevAsk,
+                             const TopOfBook& top)
 {
-    if (prevBid != curBid) {
-        if (curBid) {
-            log << "[Market] Best Bid: " << curBid->price << " x " << curBid->quantity << "\n";
+    if (changes & kBidChanged) {
+        if (top.bid) {
+            log.write(kBestBid, top.bid.price(), top.bid.quantity);
         } else if (prevBid) {
-            log << "[Market] Best Bid: " << prevBid->price << " removed\n";
+            log.write(kBestBidRemoved, prevBid.price());
         }
     }
-    if (prevAsk != curAsk) {
-        if (curAsk) {
-            if (!prevAsk)
-                log << "[Market] Best Ask: " << curAsk->price << " x " << curAsk->quantity << "\n";
+    if (changes & kAskChanged) {
+        if (top.ask) {
+            // "New Ask" when the level moved; a first ask or a size change is "Best Ask"
+            if ((changes & kAskPriceChanged) && prevAsk)
+                log.write(kNewAsk, top.ask.price(), top.ask.quantity);
             else
-                log << "[Market] New Ask: " << curAsk->price << " x " << curAsk->quantity << "\n";
+                log.write(kBestAsk, top.ask.price(), top.ask.quantity);
         } else if (prevAsk) {
-            log << "[Market] Best Ask: " << prevAsk->price << " removed\n";
+            log.write(kBestAskRemoved, prevAsk.price());
         }
     }
 }
 
-int main(){
-    std::ofstream log("output.log");
-    MarketSnapshot snapshot;
-    OrderManager om;
+// Batch mode: every file replayed independently on a work-stealing pool, no output.log
+static int run_batch(int argc, char** argv) {
+    unsigned threads = std::thread::hardware_concurrency();
+    std::vector<std::string> args;
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--threads" && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long n = std::strtoul(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || n == 0 || n > 1024) {
+                std::cerr << "Error: --threads wants a number from 1 to 1024, got " << argv[i] << "\n";
+                return 2;
+            }
+            threads = unsigned(n);
+        } else {
+            args.push_back(a);
+        }
+    }
+    const std::vector<std::string> files = list_feed_files(args);
+    if (files.empty()) {
+        std::cerr << "Error: no feed files given\n";
+        return 1;
+    }
+    const BatchRun run = replay_batch(files, threads);
+    print_batch_summary(run);
+    for (const FileReplayResult& f : run.files)
+        if (!f.ok) return 1;
+    return 0;
+}
 
-    const double sell_threshold = 100.00;
-    const int    order_qty      = 50;
+// main [feed]                 replay a text or binary feed (default sample_feed.txt)
+// main --convert in.txt out.bin
+// main --batch [--threads N] dir|file...
+int main(int argc, char** argv){
+    if (argc >= 2 && std::string(argv[1]) == "--batch") return run_batch(argc, argv);
+    if (argc == 4 && std::string(argv[1]) == "--convert") {
+        uint64_t records = 0;
+        if (!convert_text_feed(argv[2], argv[3], &records)) return 1;
+        std::cout << "Wrote " << records << " records to " << argv[3] << "\n";
+        return 0;
+    }
+    const std::string feed_path = argc > 1 ? argv[1] : "sample_feed.txt";
 
-    std::unordered_map<int,int> initial_qty;
+    DefaultStrategies strategies = make_default_strategies();
+    const std::vector<std::string> formats = log_formats(DefaultStrategies::names());
+    std::vector<const char*> format_ptrs;
+    for (const std::string& f : formats) format_ptrs.push_back(f.c_str());
+    AsyncLogger log("output.log", format_ptrs.data(), format_ptrs.size(),
+                    AsyncLogger::Overflow::Block, 1 << 16);
+    MarketSnapshot snapshot;
 
-    const PriceLevel* lastBid = nullptr;
-    const PriceLevel* lastAsk = nullptr;
+    auto journal = [&](const OrderEvent& e) {
+        const int base = kStrategyFormats + int(e.strategy) * kPerStrategy;
+        const MyOrder& o = e.order;
+        switch (e.kind) {
+            case OrderEventKind::Placed:
+                log.write(base + (o.side == Side::Buy ? kPlaceBuy : kPlaceSell), o.price, o.quantity, o.id);
+                break;
+            case OrderEventKind::Cancelled:
+                log.write(base + kCancelled, o.id, o.filled, o.quantity);
+                break;
+            case OrderEventKind::PartialFill:
+                log.write(base + kPartial, o.id, o.filled, o.quantity);
+                break;
+            case OrderEventKind::Completed:
+                log.write(base + kCompleted, o.id, o.quantity, o.quantity);
+                break;
+        }
+    };
 
-    auto feed = load_feed("sample_feed.txt");
-    for (const auto& ev : feed) {
+    BookLevel lastBid, lastAsk;
+
+    // Events are processed as the mapped file is parsed; the feed is never held in a vector
+    for_each_feed_event(feed_path, [&](const FeedEvent& ev) {
+        uint8_t changes = kNoChange;
         switch (ev.type) {
             case FeedType::BID:
-                snapshot.update_bid(ev.price, ev.quantity);
+                changes = snapshot.update_bid_ticks(ev.ticks, ev.quantity);
                 break;
             case FeedType::ASK:
-                snapshot.update_ask(ev.price, ev.quantity);
+                changes = snapshot.update_ask_ticks(ev.ticks, ev.quantity);
                 break;
-            case FeedType::EXECUTION: {
-                log << "[Execution] Order " << ev.order_id << " filled: " << ev.quantity << "\n";
-                om.handle_fill(ev.order_id, ev.quantity);
-
-                // If still active → partial; if removed → completed
-                if (const MyOrder* o = om.get(ev.order_id)) {
-                    log << "[Order] Order " << o->id << " partially filled: "
-                        << o->filled << " / " << o->quantity << "\n";
-                } else {
-                    int Q = initial_qty[ev.order_id];
-                    log << "[Order] Order " << ev.order_id << " completed ("
-                        << Q << " / " << Q << ") and removed\n";
-                }
+            case FeedType::EXECUTION:
+                log.write(kExecution, ev.order_id, ev.quantity);
+                strategies.on_execution(ev.order_id, ev.quantity, journal);
                 break;
-            }
             default: break;
         }
 
-        const PriceLevel* curBid = snapshot.get_best_bid();
-        const PriceLevel* curAsk = snapshot.get_best_ask();
-        log_best_changes(log, lastBid, lastAsk, curBid, curAsk);
-        lastBid = curBid;
-        lastAsk = curAsk;
+        // Executions and updates below the touch leave the top alone: nothing to do
+        if (changes == kNoChange) return;
+        const TopOfBook& top = snapshot.top();
+        log_best_changes(log, changes, lastBid, lastAsk, top);
+        lastBid = top.bid;
+        lastAsk = top.ask;
 
-        if (curBid && curBid->price > sell_threshold) {
-            int id = om.place_order(Side::Sell, curBid->price, order_qty);
-            initial_qty[id] = order_qty;
-            log << "[Strategy] Placing SELL order at " << curBid->price
-                << " x " << order_qty << " (ID = " << id << ")\n";
-        }
-    }
+        strategies.on_top(top, changes, journal);
+    });
 
-    std::cout << "Active orders:\n";
-    om.print_active_orders();
+    log.close();
+    strategies.for_each([](size_t, const char* name, const OrderManager& om, const StrategyStats& st) {
+        std::cout << "Active orders (" << name << "): " << om.active() << " of " << st.placed
+                  << " placed, " << st.fills << " fills, " << st.cancelled << " cancelled, position "
+                  << st.position << "\n";
+        om.print_active_orders();
+    });
     std::cout << "Wrote log to output.log\n";
     return 0;
 }
@@ -0,0 +1,234 @@
+//
+// Zero-copy feed reader: the file is mmap'd and scanned in place with a hand-written
+// number parser (no locale, no istringstream, no std::string per line). Events are
+// handed out one at a time through FeedCursor::next or for_each_event, so the caller
+// processes each event while the rest of the file is still unparsed; nothing is
+// materialized into a vector.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "feed_parser.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ORDERBOOK_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file. mmap where available, otherwise one read into memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept {
+        if (this != &o) {
+            close();
+            data_ = o.data_; size_ = o.size_; mapped_ = o.mapped_; buffer_ = std::move(o.buffer_);
+            o.data_ = nullptr; o.size_ = 0; o.mapped_ = false;
+        }
+        return *this;
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef ORDERBOOK_HAVE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd); return false; }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) { ::close(fd); data_ = ""; return true; }
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference
+        if (p == MAP_FAILED) { size_ = 0; return false; }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        mapped_ = true;
+        return true;
+#else
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        buffer_.resize(static_cast<size_t>(std::ftell(f)));
+        std::fseek(f, 0, SEEK_SET);
+        size_ = std::fread(&buffer_[0], 1, buffer_.size(), f);
+        std::fclose(f);
+        data_ = buffer_.data();
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef ORDERBOOK_HAVE_MMAP
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr; size_ = 0; mapped_ = false;
+        buffer_.clear();
+    }
+
+    bool is_open() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    const char* end() const { return data_ + size_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string buffer_; // fallback storage only
+};
+
+namespace feed_detail {
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline void skip_blanks(const char*& p, const char* end) {
+    while (p < end && is_blank(*p)) ++p;
+}
+
+// [-]digits; false if no digit
+inline bool parse_int64(const char*& p, const char* end, int64_t& out) {
+    skip_blanks(p, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    const char* start = p;
+    int64_t v = 0;
+    while (p < end && unsigned(*p - '0') < 10) v = v * 10 + (*p++ - '0');
+    if (p == start) return false;
+    out = neg ? -v : v;
+    return true;
+}
+
+inline bool parse_int(const char*& p, const char* end, int& out) {
+    int64_t v;
+    if (!parse_int64(p, end, v)) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+// [-]digits[.digits], no exponent. The digits are collected into an exact integer and
+// divided once by an exact power of ten, which rounds the same way strtod does for up to
+// 15 significant digits (every price in the feed).
+inline bool parse_price(const char*& p, const char* end, double& out) {
+    static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    skip_blanks(p, end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    uint64_t mant = 0;
+    int digits = 0, frac = 0;
+    for (; p < end && unsigned(*p - '0') < 10; ++p, ++digits)
+        if (digits < 18) mant = mant * 10 + unsigned(*p - '0');
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && unsigned(*p - '0') < 10; ++p, ++digits)
+            if (digits < 18 && frac < 15) { mant = mant * 10 + unsigned(*p - '0'); ++frac; }
+    }
+    if (digits == 0) return false;
+    const double v = static_cast<double>(mant) / kPow10[frac];
+    out = neg ? -v : v;
+    return true;
+}
+
+// Matches a whole keyword followed by a blank or end of line
+inline bool match_word(const char*& p, const char* end, const char* word, size_t len) {
+    if (size_t(end - p) < len) return false;
+    for (size_t i = 0; i < len; ++i)
+        if (p[i] != word[i]) return false;
+    if (p + len < end && !is_blank(p[len]) && p[len] != '\n') return false;
+    p += len;
+    return true;
+}
+
+} // namespace feed_detail
+
+// Pull-style cursor over a text feed in memory. Same grammar as load_feed: '#' comments
+// and blank lines are skipped, lines with missing fields are dropped, unknown types are
+// reported on stderr.
+class FeedCursor {
+public:
+    FeedCursor(const char* begin, const char* end) : p_(begin), end_(end) {}
+
+    // Next event, false at end of input
+    bool next(FeedEvent& ev) {
+        using namespace feed_detail;
+        while (p_ < end_) {
+            const char* line = p_;
+            const char* eol = static_cast<const char*>(std::memchr(p_, '\n', size_t(end_ - p_)));
+            if (!eol) eol = end_;
+            p_ = eol < end_ ? eol + 1 : end_;
+
+            const char* q = line;
+            skip_blanks(q, eol);
+            if (q == eol || *q == '#') continue;
+
+            FeedType type = FeedType::UNKNOWN;
+            if (match_word(q, eol, "BID", 3))            type = FeedType::BID;
+            else if (match_word(q, eol, "ASK", 3))       type = FeedType::ASK;
+            else if (match_word(q, eol, "EXECUTION", 9)) type = FeedType::EXECUTION;
+
+            if (type == FeedType::BID || type == FeedType::ASK) {
+                double price; int qty;
+                if (parse_price(q, eol, price) && parse_int(q, eol, qty)) {
+                    ev = {type, price, qty, -1, price_to_ticks(price)};
+                    return true;
+                }
+            } else if (type == FeedType::EXECUTION) {
+                OrderId order_id;
+                int filled;
+                if (parse_int64(q, eol, order_id) && parse_int(q, eol, filled)) {
+                    ev = {FeedType::EXECUTION, 0.0, filled, order_id};
+                    return true;
+                }
+            } else {
+                ++unknown_;
+                std::fprintf(stderr, "Unknown event type: %.*s\n", int(eol - line), line);
+            }
+        }
+        return false;
+    }
+
+    size_t unknown_lines() const { return unknown_; }
+
+private:
+    const char* p_;
+    const char* end_;
+    size_t unknown_ = 0;
+};
+
+// on_event(const FeedEvent&) for every event in [begin, end); returns the event count
+template <typename Fn>
+size_t for_each_event(const char* begin, const char* end, Fn&& on_event) {
+    FeedCursor cur(begin, end);
+    FeedEvent ev;
+    size_t n = 0;
+    while (cur.next(ev)) {
+        on_event(static_cast<const FeedEvent&>(ev));
+        ++n;
+    }
+    return n;
+}
+
+// Maps the file and streams its events; false if the file can't be opened
+template <typename Fn>
+bool for_each_event(const std::string& filename, Fn&& on_event) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Error: could not open file " << filename << "\n";
+        return false;
+    }
+    for_each_event(file.data(), file.end(), std::forward<Fn>(on_event));
+    return true;
+}
@@ -2,7 +2,110 @@
 // Created by tianci chen on 10/1/25.
 //
 #include"market_snapshot.h"
-void MarketSnapshot :: update_bid(double price, int qty){
+#include<algorithm>
+
+void PriceLadder :: set(int64_t ticks, int qty){
+    const int64_t i = ticks - base_;
+    const bool inside = i >= 0 && i < int64_t(qty_.size());
+    if(qty <= 0) {
+        if (!inside) { far_.erase(ticks); return; }
+        if (qty_[size_t(i)] == 0) return;
+        qty_[size_t(i)] = 0;
+        --live_;
+        if (i == best_) rescan_best();
+        return;
+    }
+    if (!cover(ticks)) {
+        // No room to grow: a new touch moves the window, anything else is parked
+        if (best_ < 0 || better(ticks, base_ + best_)) {
+            far_[ticks] = qty;
+            recenter(ticks);
+        } else {
+            far_[ticks] = qty;
+        }
+        return;
+    }
+    const int64_t j = ticks - base_;
+    if (qty_[size_t(j)] == 0) ++live_;
+    qty_[size_t(j)] = qty;
+    if (best_ < 0 || better(j, best_)) best_ = j;
+}
+
+// Grow the window (at least doubling, at most kMaxSpan) so `ticks` falls inside it;
+// false if that would take more than kMaxSpan
+bool PriceLadder :: cover(int64_t ticks){
+    const int64_t size = int64_t(qty_.size());
+    if (size > 0 && ticks >= base_ && ticks < base_ + size) return true;
+    if (size == 0) {
+        const int64_t initial = 1024;
+        qty_.assign(size_t(initial), 0);
+        base_ = ticks - initial / 2;
+        return true;
+    }
+    const int64_t lo = std::min(base_, ticks), hi = std::max(base_ + size, ticks + 1);
+    if (hi - lo > kMaxSpan) return false;
+    const int64_t new_size = std::min(kMaxSpan, std::max(2 * size, 2 * (hi - lo)));
+    const int64_t new_base = lo - (new_size - (hi - lo)) / 2; // leave room on both sides
+    std::vector<int> grown(size_t(new_size), 0);
+    std::copy(qty_.begin(), qty_.end(), grown.begin() + (base_ - new_base));
+    if (best_ >= 0) best_ += base_ - new_base;
+    qty_.swap(grown);
+    base_ = new_base;
+    // Parked levels the bigger window now covers move in, as in recenter
+    for (auto it = far_.lower_bound(new_base); it != far_.end() && it->first < new_base + new_size;) {
+        const int64_t j = it->first - new_base;
+        qty_[size_t(j)] = it->second;
+        ++live_;
+        if (best_ < 0 || better(j, best_)) best_ = j;
+        it = far_.erase(it);
+    }
+    return true;
+}
+
+// Best level was removed: walk away from the touch to the next live level, or bring
+// the window to the parked levels when it has none left
+void PriceLadder :: rescan_best(){
+    if (live_ == 0) {
+        best_ = -1;
+        if (!far_.empty()) recenter(bids_ ? far_.rbegin()->first : far_.begin()->first);
+        return;
+    }
+    const int64_t step = bids_ ? -1 : 1;
+    int64_t i = best_ + step;
+    while (qty_[size_t(i)] == 0) i += step;
+    best_ = i;
+}
+
+// Slide the window (same size) so it is centred on `center`, the new touch. Levels that
+// fall out are parked in far_, parked levels that fall in are moved back. O(window),
+// which only an outlier quote or a drift of half the window pays.
+void PriceLadder :: recenter(int64_t center){
+    const int64_t size = int64_t(qty_.size());
+    const int64_t new_base = center - size / 2;
+    std::vector<int> moved(size_t(size), 0);
+    for (int64_t i = 0; i < size; ++i) {
+        const int q = qty_[size_t(i)];
+        if (q == 0) continue;
+        const int64_t t = base_ + i;
+        if (t >= new_base && t < new_base + size) moved[size_t(t - new_base)] = q;
+        else far_[t] = q;
+    }
+    for (auto it = far_.lower_bound(new_base); it != far_.end() && it->first < new_base + size;) {
+        moved[size_t(it->first - new_base)] = it->second;
+        it = far_.erase(it);
+    }
+    qty_.swap(moved);
+    base_ = new_base;
+    live_ = 0;
+    best_ = -1;
+    for (int64_t i = 0; i < size; ++i) {
+        if (qty_[size_t(i)] == 0) continue;
+        ++live_;
+        if (best_ < 0 || better(i, best_)) best_ = i;
+    }
+}
+
+void MapMarketSnapshot :: update_bid(double price, int qty){
     if(qty <= 0) {
         bids.erase(price);
         return;
@@ -16,7 +119,7 @@ void MarketSnapshot :: update_bid(double price, int qty){
         it ->second->quantity = qty;
     }
 }
-void MarketSnapshot :: update_ask(double price, int qty){
+void MapMarketSnapshot :: update_ask(double price, int qty){
     if(qty <= 0) {
         asks.erase(price);
         return;
@@ -31,15 +134,15 @@ void MarketSnapshot :: update_ask(double price, int qty){
     }
 
 }
-const PriceLevel* MarketSnapshot ::  get_best_bid() const{
+const PriceLevel* MapMarketSnapshot ::  get_best_bid() const{
     if (bids.empty()){
         return nullptr;
     }
     return bids.begin() -> second.get();
 }
-const PriceLevel* MarketSnapshot ::  get_best_ask() const{
+const PriceLevel* MapMarketSnapshot ::  get_best_ask() const{
     if (asks.empty()){
         return nullptr;
     }
     return asks.begin() -> second.get();
-}
\ No newline at end of file
+}
@@ -1,8 +1,12 @@
 //
 // Created by tianci chen on 10/1/25.
 //
+#include<cstdint>
+#include<functional>
 #include<map>
 #include<memory>
+#include<vector>
+#include"feed_parser.h"
 
 #ifndef BUILD_LOCAL_ORDER_BOOK_MARKET_SNAPSHOT_H
 #define BUILD_LOCAL_ORDER_BOOK_MARKET_SNAPSHOT_H
@@ -13,14 +17,126 @@ struct PriceLevel {
     PriceLevel(double p, int q) : price(p), quantity(q) {}
 };
 
+// Top-of-book level by value. Callers keep `ticks` as the handle to a level (it stays
+// valid across updates), never a pointer into the book.
+struct BookLevel {
+    int64_t ticks = 0;
+    int quantity = 0;   // 0 = no level (side empty)
+
+    double price() const { return ticks_to_price(ticks); }
+    explicit operator bool() const { return quantity > 0; }
+};
+
+// One side of the book as a tick-indexed array of quantities (0 = empty level), with
+// the best index cached. Set is O(1); removing the best level scans to the next live
+// one, which is a few slots in a normal book. The window grows (doubling) when a price
+// lands outside it, up to kMaxSpan ticks. Levels beyond that go to a sparse map, and
+// the window re-centers on the touch whenever the best level would fall outside it, so
+// an outlier quote or a day's drift costs a re-center, never an unbounded array.
+class PriceLadder {
+public:
+    static constexpr int64_t kMaxSpan = int64_t(1) << 16;  // 256 KB of levels per side
+
+    explicit PriceLadder(bool bids) : bids_(bids) {}
+
+    void set(int64_t ticks, int qty);
+    BookLevel best() const {
+        return best_ < 0 ? BookLevel{} : BookLevel{base_ + best_, qty_[size_t(best_)]};
+    }
+    int quantity_at(int64_t ticks) const {
+        const int64_t i = ticks - base_;
+        if (i >= 0 && i < int64_t(qty_.size())) return qty_[size_t(i)];
+        auto it = far_.find(ticks);
+        return it == far_.end() ? 0 : it->second;
+    }
+    size_t levels() const { return live_ + far_.size(); }
+    size_t window() const { return qty_.size(); }
+
+private:
+    bool better(int64_t i, int64_t j) const { return bids_ ? i > j : i < j; }
+    bool cover(int64_t ticks);
+    void rescan_best();
+    void recenter(int64_t center);
+
+    bool bids_;
+    std::vector<int> qty_;
+    int64_t base_ = 0;     // ticks of qty_[0]
+    int64_t best_ = -1;    // index into qty_, -1 when the side is empty
+    size_t live_ = 0;      // live levels inside the window
+    // Levels outside the window. Always worse than every level inside it: a better one
+    // becomes the touch and the window re-centers onto it.
+    std::map<int64_t, int> far_;
+};
+
+// Which parts of the top of book an update changed. A level appearing or disappearing
+// counts as a price change; SIZE is set whenever the best quantity differs.
+enum TopChange : uint8_t {
+    kNoChange        = 0,
+    kBidPriceChanged = 1 << 0,
+    kBidSizeChanged  = 1 << 1,
+    kAskPriceChanged = 1 << 2,
+    kAskSizeChanged  = 1 << 3,
+    kBidChanged      = kBidPriceChanged | kBidSizeChanged,
+    kAskChanged      = kAskPriceChanged | kAskSizeChanged,
+};
+
+// Best bid and ask as published by the snapshot; version goes up by one per update
+// that changed either of them
+struct TopOfBook {
+    uint64_t version = 0;
+    BookLevel bid;
+    BookLevel ask;
+};
+
+// Integer-tick snapshot: prices become ticks when parsed (FeedEvent::ticks) and levels
+// live inline in a PriceLadder per side, so the best bid and ask are O(1) reads with no
+// map nodes, heap levels or double comparisons. Every update returns the TopChange
+// flags it caused, so a caller can skip all top-of-book work when a deeper level moved.
 class MarketSnapshot {
+public:
+    uint8_t update_bid(double price, int qty) { return update_bid_ticks(price_to_ticks(price), qty); }
+    uint8_t update_ask(double price, int qty) { return update_ask_ticks(price_to_ticks(price), qty); }
+    uint8_t update_bid_ticks(int64_t ticks, int qty) {
+        bids.set(ticks, qty);
+        return publish(top_.bid, bids.best(), kBidPriceChanged, kBidSizeChanged);
+    }
+    uint8_t update_ask_ticks(int64_t ticks, int qty) {
+        asks.set(ticks, qty);
+        return publish(top_.ask, asks.best(), kAskPriceChanged, kAskSizeChanged);
+    }
+    const TopOfBook& top() const { return top_; }
+    BookLevel get_best_bid() const { return top_.bid; }
+    BookLevel get_best_ask() const { return top_.ask; }
+    int bid_quantity_at(int64_t ticks) const { return bids.quantity_at(ticks); }
+    int ask_quantity_at(int64_t ticks) const { return asks.quantity_at(ticks); }
+    size_t bid_levels() const { return bids.levels(); }
+    size_t ask_levels() const { return asks.levels(); }
+private:
+    uint8_t publish(BookLevel& published, const BookLevel& best, uint8_t price_flag, uint8_t size_flag) {
+        uint8_t flags = kNoChange;
+        if (bool(best) != bool(published) || (best && best.ticks != published.ticks)) flags |= price_flag;
+        if (best.quantity != published.quantity) flags |= size_flag;
+        if (flags) {
+            published = best;
+            ++top_.version;
+        }
+        return flags;
+    }
+
+    PriceLadder bids{true};
+    PriceLadder asks{false};
+    TopOfBook top_;
+};
+
+// The original node-based snapshot, kept as the benchmark baseline
+class MapMarketSnapshot {
 public:
     void update_bid(double price, int qty);
     void update_ask(double price, int qty);
     const PriceLevel* get_best_bid() const;
     const PriceLevel* get_best_ask() const;
 private:
-    std::map<double, std::unique_ptr<PriceLevel>> bids; // sorted descending
+    std::map<double, std::unique_ptr<PriceLevel>, std::greater<double>> bids; // sorted descending
     std::map<double, std::unique_ptr<PriceLevel>> asks; // sorted ascending
 };
 
@@ -2,6 +2,7 @@
 // Created by tianci chen on 10/1/25.
 //
 #include"order_manager.h"
+#include<stdexcept>
 
 static const char* to_string(Side s) {
     return s == Side::Buy ? "BUY" : "SELL";
@@ -16,13 +17,87 @@ static const char* to_string(OrderStatus st) {
     return "Unknown";
 }
 
-static int next_order_id() {
-    static int id = 1;
-    return id++;
+OrderId OrderManager::place_order(Side side, double price, int qty) {
+    uint32_t index;
+    if (free_head >= 0) {
+        index = uint32_t(free_head);
+    } else {
+        if (used == kMaxSlots) throw std::length_error("OrderManager: too many live orders");
+        index = used++;
+        if ((index >> kChunkBits) == chunks.size())
+            chunks.emplace_back(new Slot[size_t(1) << kChunkBits]);
+    }
+    Slot& s = chunks[index >> kChunkBits][index & ((1u << kChunkBits) - 1)];
+    if (free_head >= 0) free_head = s.next_free;
+
+    const OrderId id = OrderId((uint64_t(s.generation) << kSlotBits) | (index + 1));
+    s.order    = MyOrder{id, side, price, qty};
+    s.live     = true;
+    ++live_count;
+    return id;
+}
+
+OrderManager::Slot* OrderManager::slot_of(OrderId id) const {
+    if (id <= 0) return nullptr;
+    const uint32_t index = (uint32_t(id) & kSlotMask) - 1;
+    if (index >= used) return nullptr;
+    Slot& s = chunks[index >> kChunkBits][index & ((1u << kChunkBits) - 1)];
+    return s.live && s.order.id == id ? &s : nullptr;
 }
 
-int OrderManager::place_order(Side side, double price, int qty) {
-    const int id = next_order_id();
+void OrderManager::release(Slot& s, uint32_t index) {
+    s.live = false;
+    s.generation = (s.generation + 1) & ((1u << kGenBits) - 1);
+    s.next_free = free_head;
+    free_head = int32_t(index);
+    --live_count;
+}
+
+void OrderManager::cancel(OrderId id) {
+    Slot* s = slot_of(id);
+    if (!s) return;
+    s->order.status = OrderStatus::Cancelled;
+    release(*s, (uint32_t(id) & kSlotMask) - 1);
+}
+
+void OrderManager::handle_fill(OrderId id, int filled_qty) {
+    Slot* s = slot_of(id);
+    if (!s || filled_qty <= 0) return;
+
+    MyOrder* o = &s->order;
+    o->filled += filled_qty;
+    if (o->filled >= o->quantity) {
+        o->filled = o->quantity;
+        o->status = OrderStatus::Filled;
+        release(*s, (uint32_t(id) & kSlotMask) - 1);
+    } else {
+        o->status = OrderStatus::PartiallyFilled;
+    }
+}
+
+// Slot order, which is id order until slots are recycled
+void OrderManager::print_active_orders() const {
+    for (uint32_t i = 0; i < used; ++i) {
+        const Slot& s = chunks[i >> kChunkBits][i & ((1u << kChunkBits) - 1)];
+        if (!s.live) continue;
+        const MyOrder& o = s.order;
+        std::cout << "Order " << o.id << " "
+                  << to_string(o.side)
+                  << " @" << o.price
+                  << " qty=" << o.quantity
+                  << " filled=" << o.filled
+                  << " status=" << to_string(o.status)
+                  << "\n";
+    }
+}
+
+const MyOrder* OrderManager::get(OrderId id) const{
+    const Slot* s = slot_of(id);
+    return s ? &s->order : nullptr;
+}
+
+OrderId MapOrderManager::place_order(Side side, double price, int qty) {
+    const OrderId id = next_id++;
 
     auto ord = std::make_unique<MyOrder>();
     ord->id       = id;
@@ -36,14 +111,14 @@ int OrderManager::place_order(Side side, double price, int qty) {
     return id;
 }
 
-void OrderManager::cancel(int id) {
+void MapOrderManager::cancel(OrderId id) {
     auto it = orders.find(id);
     if (it == orders.end()) return;
     it->second->status = OrderStatus::Cancelled;
     orders.erase(it);
 }
 
-void OrderManager::handle_fill(int id, int filled_qty) {
+void MapOrderManager::handle_fill(OrderId id, int filled_qty) {
     auto it = orders.find(id);
     if (it == orders.end() || filled_qty <= 0) return;
 
@@ -58,20 +133,7 @@ void OrderManager::handle_fill(int id, int filled_qty) {
     }
 }
 
-void OrderManager::print_active_orders() const {
-    for (const auto& kv : orders) {
-        const MyOrder& o = *kv.second;
-        std::cout << "Order " << o.id << " "
-                  << to_string(o.side)
-                  << " @" << o.price
-                  << " qty=" << o.quantity
-                  << " filled=" << o.filled
-                  << " status=" << to_string(o.status)
-                  << "\n";
-    }
-}
-
-const MyOrder* OrderManager::get(int id) const{
+const MyOrder* MapOrderManager::get(OrderId id) const{
     auto it = orders.find(id);
     return it==orders.end()? nullptr : it->second.get();
-}
\ No newline at end of file
+}
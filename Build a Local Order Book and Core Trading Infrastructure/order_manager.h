@@ -2,8 +2,10 @@
 // Created by tianci chen on 10/1/25.
 //
 #pragma once
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <vector>
 #include <iostream>
 #include "market_snapshot.h"
 
@@ -14,7 +16,7 @@ enum class OrderStatus { New, Filled, PartiallyFilled, Cancelled };
 enum class Side { Buy, Sell };
 
 struct MyOrder {
-    int id;
+    OrderId id;
     Side side;
     double price;
     int quantity;
@@ -22,14 +24,56 @@ struct MyOrder {
     OrderStatus status = OrderStatus::New;
 };
 
+// Orders live in a slab: fixed-size chunks of slots that are never moved or freed, so
+// place/fill/cancel are O(1) with no heap allocation per order and get() pointers stay
+// valid while the order is live. Finished orders return their slot to a free list.
+//
+// An id is a 64-bit handle: (generation << 32) | (slot + 1). The first orders get ids
+// 1, 2, 3...; a recycled slot bumps its generation, so an id kept after its order was
+// filled or cancelled no longer matches and is ignored (stale). The free list is LIFO,
+// so one slot can be recycled on every order; with a 31-bit generation a stale id can
+// only alias after 2^31 reuses of the same slot.
 class OrderManager{
 public:
-    int place_order(Side side, double price, int qty);
-    void cancel(int id);
-    void handle_fill(int id, int filled_qty);
+    OrderId place_order(Side side, double price, int qty);
+    void cancel(OrderId id);
+    void handle_fill(OrderId id, int filled_qty);
     void print_active_orders() const;
-    const MyOrder* get(int id) const;
+    const MyOrder* get(OrderId id) const;
+    size_t active() const { return live_count; }
+private:
+    static constexpr int kSlotBits = 32;
+    static constexpr int kGenBits = 63 - kSlotBits;  // keeps ids positive
+    static constexpr uint32_t kSlotMask = 0xffffffffu;
+    static constexpr uint32_t kMaxSlots = 0x7fffffffu;    // free-list links are int32
+    static constexpr int kChunkBits = 12;            // 4096 slots per chunk
+
+    struct Slot {
+        MyOrder order;
+        uint32_t generation = 0;
+        int32_t next_free = -1;
+        bool live = false;
+    };
+
+    Slot* slot_of(OrderId id) const;  // live slot for this id, nullptr if unknown or stale
+    void release(Slot& s, uint32_t index);
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    uint32_t used = 0;            // slots handed out at least once
+    int32_t free_head = -1;
+    size_t live_count = 0;
+};
+
+// The original map + make_unique manager, kept as the benchmark baseline
+class MapOrderManager{
+public:
+    OrderId place_order(Side side, double price, int qty);
+    void cancel(OrderId id);
+    void handle_fill(OrderId id, int filled_qty);
+    const MyOrder* get(OrderId id) const;
+    size_t active() const { return orders.size(); }
 private:
+    OrderId next_id = 1;
     std::map<int, std::unique_ptr<MyOrder>> orders;
 };
 
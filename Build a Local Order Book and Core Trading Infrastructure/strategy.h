@@ -0,0 +1,274 @@
+//
+// Strategy plug-ins with static dispatch. A strategy is a plain type with
+//     static constexpr const char* kName;
+//     static constexpr uint8_t kWakeOn;   // TopChange flags it reacts to
+//     template <typename Orders> void on_top(const TopOfBook&, uint8_t changes, Orders&);
+// StrategyHarness<S...> keeps every strategy in a tuple next to its own OrderManager and
+// calls them through a fold over the tuple: no virtual calls, and each on_top can be
+// inlined into the replay loop. One pass over the feed drives all of them; feed
+// executions are offered to every strategy and applied where the id is a live order.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "market_snapshot.h"
+#include "order_manager.h"
+
+// What a strategy's orders did, reported to the harness listener
+enum class OrderEventKind : uint8_t { Placed, Cancelled, PartialFill, Completed };
+
+struct OrderEvent {
+    OrderEventKind kind;
+    size_t strategy;   // index in the harness
+    MyOrder order;     // state after the event
+    int fill_qty;      // PartialFill / Completed only
+};
+
+struct NullOrderListener {
+    void operator()(const OrderEvent&) {}
+};
+
+// Per-strategy totals. Fills are assumed at the order's limit price.
+struct StrategyStats {
+    uint64_t placed = 0;
+    uint64_t cancelled = 0;
+    uint64_t fills = 0;
+    int64_t position = 0;    // bought - sold
+    int64_t cash_ticks = 0;  // sold notional - bought notional, in ticks
+
+    // Cash plus the position marked at `mark_ticks`
+    int64_t pnl_ticks(int64_t mark_ticks) const { return cash_ticks + position * mark_ticks; }
+    bool operator==(const StrategyStats& o) const {
+        return placed == o.placed && cancelled == o.cancelled && fills == o.fills &&
+               position == o.position && cash_ticks == o.cash_ticks;
+    }
+};
+
+// Order entry handed to on_top: the strategy's own OrderManager, counted and reported
+template <typename Listener>
+class StrategyOrders {
+public:
+    StrategyOrders(OrderManager& om, StrategyStats& stats, Listener& listener, size_t index)
+        : om_(om), stats_(stats), listener_(listener), index_(index) {}
+
+    OrderId place(Side side, int64_t ticks, int qty) {
+        const OrderId id = om_.place_order(side, ticks_to_price(ticks), qty);
+        ++stats_.placed;
+        listener_(OrderEvent{OrderEventKind::Placed, index_, *om_.get(id), 0});
+        return id;
+    }
+    OrderId buy(int64_t ticks, int qty) { return place(Side::Buy, ticks, qty); }
+    OrderId sell(int64_t ticks, int qty) { return place(Side::Sell, ticks, qty); }
+
+    // False if the order is no longer live (filled, cancelled or unknown)
+    bool cancel(OrderId id) {
+        const MyOrder* o = om_.get(id);
+        if (!o) return false;
+        MyOrder last = *o;
+        om_.cancel(id);
+        last.status = OrderStatus::Cancelled;
+        ++stats_.cancelled;
+        listener_(OrderEvent{OrderEventKind::Cancelled, index_, last, 0});
+        return true;
+    }
+
+    const MyOrder* get(OrderId id) const { return om_.get(id); }
+
+private:
+    OrderManager& om_;
+    StrategyStats& stats_;
+    Listener& listener_;
+    size_t index_;
+};
+
+//=============================
+// Strategies
+//=============================
+
+// Sells `qty` at the bid once it rises above the threshold. While the bid stays up it
+// sells again only after climbing another `step` ticks past the last sale; it re-arms
+// once the bid falls `band` ticks below the threshold. (The original rule sold on every
+// event above the threshold.)
+struct ThresholdSell {
+    static constexpr const char* kName = "threshold";
+    static constexpr uint8_t kWakeOn = kBidChanged;
+
+    ThresholdSell(int64_t threshold_ticks, int qty, int64_t step_ticks, int64_t band_ticks)
+        : threshold(threshold_ticks), qty(qty), step(step_ticks), band(band_ticks) {}
+
+    template <typename Orders>
+    void on_top(const TopOfBook& top, uint8_t, Orders& orders) {
+        if (!top.bid) return;
+        const int64_t bid = top.bid.ticks;
+        if (last_sale != 0) {
+            if (bid < threshold - band) last_sale = 0;   // re-arm
+            else if (bid < last_sale + step) return;
+        }
+        if (bid > threshold) {
+            orders.sell(bid, qty);
+            last_sale = bid;
+        }
+    }
+
+    int64_t threshold;
+    int qty;
+    int64_t step;
+    int64_t band;
+    int64_t last_sale = 0;  // 0 = armed
+};
+
+// Quotes one tick inside the spread on both sides while the spread is at least
+// `min_spread` ticks. A quote whose price no longer matches the book is cancelled and
+// replaced; a filled quote is re-entered on the next top change.
+struct SpreadCapture {
+    static constexpr const char* kName = "spread";
+    static constexpr uint8_t kWakeOn = kBidPriceChanged | kAskPriceChanged;
+
+    SpreadCapture(int64_t min_spread_ticks, int qty) : min_spread(min_spread_ticks), qty(qty) {}
+
+    template <typename Orders>
+    void on_top(const TopOfBook& top, uint8_t, Orders& orders) {
+        const bool wide = top.bid && top.ask && top.ask.ticks - top.bid.ticks >= min_spread;
+        requote(orders, buy_id, buy_ticks, Side::Buy, wide ? top.bid.ticks + 1 : 0);
+        requote(orders, sell_id, sell_ticks, Side::Sell, wide ? top.ask.ticks - 1 : 0);
+    }
+
+    template <typename Orders>
+    void requote(Orders& orders, OrderId& id, int64_t& at, Side side, int64_t want) {
+        if (id != 0 && orders.get(id) && at == want) return;  // still live at the right price
+        if (id != 0) orders.cancel(id);
+        id = want ? orders.place(side, want, qty) : 0;
+        at = want;
+    }
+
+    int64_t min_spread;
+    int qty;
+    OrderId buy_id = 0, sell_id = 0;
+    int64_t buy_ticks = 0, sell_ticks = 0;
+};
+
+// Top-of-book size imbalance (bid - ask) / (bid + ask). Above +ratio it buys at the ask,
+// below -ratio it sells at the bid: one order per excursion, re-armed once the
+// imbalance comes back inside +-ratio/2.
+struct Imbalance {
+    static constexpr const char* kName = "imbalance";
+    static constexpr uint8_t kWakeOn = kBidChanged | kAskChanged;
+
+    Imbalance(double ratio, int qty) : ratio(ratio), qty(qty) {}
+
+    template <typename Orders>
+    void on_top(const TopOfBook& top, uint8_t, Orders& orders) {
+        if (!top.bid || !top.ask) return;
+        const double imb = double(top.bid.quantity - top.ask.quantity) /
+                           double(top.bid.quantity + top.ask.quantity);
+        if (state != 0) {
+            if (imb < ratio / 2 && imb > -ratio / 2) state = 0;
+            return;
+        }
+        if (imb > ratio) {
+            orders.buy(top.ask.ticks, qty);
+            state = 1;
+        } else if (imb < -ratio) {
+            orders.sell(top.bid.ticks, qty);
+            state = -1;
+        }
+    }
+
+    double ratio;
+    int qty;
+    int state = 0;  // side of the last signal until re-armed
+};
+
+//=============================
+// Harness
+//=============================
+template <typename... Strategies>
+class StrategyHarness {
+public:
+    static constexpr size_t kCount = sizeof...(Strategies);
+
+    explicit StrategyHarness(Strategies... s) : slots_(Slot<Strategies>{std::move(s), {}, {}}...) {}
+
+    static std::array<const char*, kCount> names() { return {Strategies::kName...}; }
+
+    template <size_t I>
+    const auto& strategy() const { return std::get<I>(slots_).strategy; }
+
+    // After a book update; strategies whose kWakeOn misses `changes` are not called
+    template <typename Listener>
+    void on_top(const TopOfBook& top, uint8_t changes, Listener& listener) {
+        if (changes == kNoChange) return;
+        for_each_slot([&](size_t i, auto& slot) {
+            if (!(changes & std::decay_t<decltype(slot.strategy)>::kWakeOn)) return;
+            StrategyOrders<Listener> orders(slot.orders, slot.stats, listener, i);
+            slot.strategy.on_top(top, changes, orders);
+        });
+    }
+
+    // A feed execution: applied to every strategy that has `id` live
+    template <typename Listener>
+    void on_execution(OrderId id, int qty, Listener& listener) {
+        for_each_slot([&](size_t i, auto& slot) {
+            const MyOrder* o = slot.orders.get(id);
+            if (!o || qty <= 0) return;
+            MyOrder after = *o;
+            const int done = std::min(qty, after.quantity - after.filled);
+            slot.orders.handle_fill(id, qty);
+            after.filled += done;
+            const int64_t notional = int64_t(done) * price_to_ticks(after.price);
+            StrategyStats& st = slot.stats;
+            ++st.fills;
+            if (after.side == Side::Buy) { st.position += done; st.cash_ticks -= notional; }
+            else                         { st.position -= done; st.cash_ticks += notional; }
+            if (const MyOrder* live = slot.orders.get(id)) {
+                listener(OrderEvent{OrderEventKind::PartialFill, i, *live, done});
+            } else {
+                after.status = OrderStatus::Filled;
+                listener(OrderEvent{OrderEventKind::Completed, i, after, done});
+            }
+        });
+    }
+
+    // fn(index, name, const OrderManager&, const StrategyStats&)
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        visit(*this, [&](size_t i, const auto& slot) {
+            fn(i, std::decay_t<decltype(slot.strategy)>::kName, slot.orders, slot.stats);
+        }, std::index_sequence_for<Strategies...>{});
+    }
+
+private:
+    template <typename S>
+    struct Slot {
+        S strategy;
+        OrderManager orders;
+        StrategyStats stats;
+    };
+
+    template <typename Fn>
+    void for_each_slot(Fn&& fn) {
+        visit(*this, fn, std::index_sequence_for<Strategies...>{});
+    }
+    // Self is the harness or a const harness
+    template <typename Self, typename Fn, size_t... I>
+    static void visit(Self& self, Fn&& fn, std::index_sequence<I...>) {
+        (fn(I, std::get<I>(self.slots_)), ...);
+    }
+
+    std::tuple<Slot<Strategies>...> slots_;
+};
+
+// The set main.cpp and the benchmarks run
+using DefaultStrategies = StrategyHarness<ThresholdSell, SpreadCapture, Imbalance>;
+
+inline DefaultStrategies make_default_strategies() {
+    return DefaultStrategies(ThresholdSell(price_to_ticks(100.00), 50, 5, 5),
+                             SpreadCapture(3, 10),
+                             Imbalance(0.6, 20));
+}
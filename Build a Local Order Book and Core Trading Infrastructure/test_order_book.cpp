@@ -0,0 +1,149 @@
+//
+// Created by tianci chen on 10/1/25.
+//
+
+// test_order_book.cpp
+// Build: g++ -std=c++17 -O2 test_order_book.cpp market_snapshot.cpp order_manager.cpp -o test_order_book -pthread
+#include "market_snapshot.h"
+#include "order_manager.h"
+#include "work_stealing_pool.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+static BookLevel level_of(const PriceLevel* p) {
+    return p ? BookLevel{price_to_ticks(p->price), p->quantity} : BookLevel{};
+}
+
+static bool same(const BookLevel& a, const BookLevel& b) {
+    return a.quantity == b.quantity && (!a || a.ticks == b.ticks);
+}
+
+// One absurd quote must not blow the ladder up, and the book must come back after it
+static void test_outlier_price() {
+    MarketSnapshot book;
+    book.update_bid(100.10, 300);
+    book.update_ask(100.20, 250);
+    book.update_bid(99999999.99, 10);
+    assert(book.get_best_bid().ticks == price_to_ticks(99999999.99));
+    assert(book.bid_quantity_at(price_to_ticks(100.10)) == 300);
+    assert(book.bid_levels() == 2);
+
+    book.update_bid(99999999.99, 0);
+    assert(book.get_best_bid().ticks == price_to_ticks(100.10));
+    assert(book.get_best_bid().quantity == 300);
+    assert(book.get_best_ask().ticks == price_to_ticks(100.20));
+
+    book.update_ask(0.01, 5);  // far below the window on the ask side: new touch
+    assert(book.get_best_ask().ticks == 1);
+    book.update_ask(0.01, 0);
+    assert(book.get_best_ask().ticks == price_to_ticks(100.20));
+}
+
+// The touch walks 200k ticks up, leaving a level behind every 100 ticks
+static void test_drift() {
+    PriceLadder bids(true);
+    for (int64_t t = 10000; t < 210000; ++t) {
+        bids.set(t, 10);
+        if (t % 100 != 0) bids.set(t - 1, 0);
+        assert(bids.best().ticks == t);
+        assert(bids.window() <= size_t(PriceLadder::kMaxSpan));
+    }
+    assert(bids.levels() == 2000);  // 1999 left behind + the touch
+    for (int64_t t = 209999; t >= 10000; --t) bids.set(t, 0);
+    assert(!bids.best());
+    assert(bids.levels() == 0);
+}
+
+// Growing the window must pull in the parked levels it now covers: 934000 is parked
+// when the window re-centers on 934900, then the grow for 933900 takes it in
+static void test_grow_over_parked() {
+    PriceLadder bids(true);
+    bids.set(1000000, 10);
+    bids.set(934900, 5);
+    bids.set(934000, 7);
+    bids.set(1000000, 0);
+    bids.set(933900, 3);
+    bids.set(934900, 0);
+    assert(bids.best().ticks == 934000 && bids.best().quantity == 7);
+    assert(bids.quantity_at(934000) == 7);
+    assert(bids.levels() == 2);
+    bids.set(934000, 0);
+    assert(bids.quantity_at(934000) == 0);
+    assert(bids.best().ticks == 933900);
+    assert(bids.levels() == 1);
+}
+
+// Random updates over a range wider than the window, checked against the map book
+static void test_against_map() {
+    std::mt19937_64 rng(11);
+    MarketSnapshot book;
+    MapMarketSnapshot ref;
+    for (int n = 0; n < 200000; ++n) {
+        const uint64_t r = rng();
+        const int64_t center = (r & 1023) < 5 ? int64_t(r >> 20) % 10000000 : 10000;
+        const int64_t ticks = std::max<int64_t>(1, center + int64_t((r >> 10) % 2001) - 1000);
+        const int qty = (r >> 40) % 4 == 0 ? 0 : int((r >> 42) % 500) + 1;
+        const double price = ticks_to_price(ticks);
+        if (r & 2) { book.update_bid(price, qty); ref.update_bid(price, qty); }
+        else       { book.update_ask(price, qty); ref.update_ask(price, qty); }
+        assert(same(book.get_best_bid(), level_of(ref.get_best_bid())));
+        assert(same(book.get_best_ask(), level_of(ref.get_best_ask())));
+    }
+}
+
+// The free list is LIFO, so place/cancel hammers one slot. An id kept from the first
+// order must stay stale well past the old 9-bit generation (512 reuses).
+static void test_generation_wrap() {
+    OrderManager om;
+    const OrderId first = om.place_order(Side::Sell, 100.10, 50);
+    assert(first == 1);
+    om.handle_fill(first, 50);
+    assert(!om.get(first));
+    for (int i = 0; i < 100000; ++i) {
+        const OrderId id = om.place_order(Side::Buy, 100.00, 10);
+        assert(id != first);
+        om.handle_fill(first, 10);          // stale: must not touch the slot's new order
+        const MyOrder* o = om.get(id);
+        assert(o && o->filled == 0 && o->status == OrderStatus::New);
+        if (i % 2) om.cancel(id);
+        else       om.handle_fill(id, 10);
+        assert(om.active() == 0);
+    }
+    const OrderId second = om.place_order(Side::Buy, 100.00, 10);
+    assert(second != first && om.get(second) && !om.get(first));
+}
+
+// A throwing task must not take its worker down: the rest still run, wait() rethrows
+static void test_pool_exception() {
+    WorkStealingPool pool(2);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; ++i)
+        pool.submit([&ran, i] {
+            if (i == 37) throw std::runtime_error("task 37");
+            ran.fetch_add(1);
+        });
+    bool threw = false;
+    try {
+        pool.wait();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && ran.load() == 99);
+    pool.submit([&ran] { ran.fetch_add(1); });
+    pool.wait();  // error already reported
+    assert(ran.load() == 100);
+}
+
+int main() {
+    test_outlier_price();
+    test_drift();
+    test_grow_over_parked();
+    test_against_map();
+    test_generation_wrap();
+    test_pool_exception();
+    std::cout << "Tests passed.\n";
+    return 0;
+}
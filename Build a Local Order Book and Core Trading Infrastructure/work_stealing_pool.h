@@ -0,0 +1,145 @@
+//
+// Work-stealing thread pool. Every worker owns a deque: it pops its own tasks from the
+// back (most recently pushed, still warm in cache) and, when that runs dry, steals from
+// the front of the other workers' deques (the oldest work, usually the largest chunk
+// left). Tasks submitted from outside are dealt round-robin; tasks submitted from
+// inside a worker go to that worker's own deque. A deque is a mutex-protected
+// std::deque, which is plenty for task sizes of milliseconds and up (one feed file).
+//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+        for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { work(i); });
+    }
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : workers_) t.join();
+    }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task) {
+        const size_t q = current_worker_owner == this ? current_worker_index
+                                                      : next_queue_++ % queues_.size();
+        {
+            // Counted before it is visible, so a worker can never take it first
+            std::lock_guard<std::mutex> lock(mu_);
+            ++pending_;
+            ++queued_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->mu);
+            queues_[q]->tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    // Blocks until every task submitted so far has finished. If a task threw, the first
+    // exception is rethrown here (the worker itself carries on).
+    void wait() {
+        std::unique_lock<std::mutex> lock(mu_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+        if (error_) {
+            std::exception_ptr e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    unsigned size() const { return unsigned(workers_.size()); }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mu;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool pop_own(size_t self, std::function<void()>& task) {
+        Queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mu);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, std::function<void()>& task) {
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            Queue& q = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mu);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t self) {
+        current_worker_owner = this;
+        current_worker_index = self;
+        std::function<void()> task;
+        for (;;) {
+            if (pop_own(self, task) || steal(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    --queued_;
+                }
+                std::exception_ptr failed;
+                try {
+                    task();
+                } catch (...) {
+                    failed = std::current_exception();
+                }
+                task = nullptr;
+                std::lock_guard<std::mutex> lock(mu_);
+                if (failed && !error_) error_ = failed;
+                if (--pending_ == 0) idle_.notify_all();
+                continue;
+            }
+            // Nothing to take: sleep until something is queued or the pool shuts down.
+            // queued_ can be ahead of the deques for a moment (see submit), which only
+            // costs another lap.
+            std::unique_lock<std::mutex> lock(mu_);
+            wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+            if (stop_ && queued_ == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    size_t pending_ = 0;   // submitted and not finished
+    size_t queued_ = 0;    // submitted and not yet taken by a worker
+    bool stop_ = false;
+    std::exception_ptr error_;  // first task exception, for wait()
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<uint64_t> steals_{0};
+
+    inline static thread_local const WorkStealingPool* current_worker_owner = nullptr;
+    inline static thread_local size_t current_worker_index = 0;
+};
@@ -4,6 +4,10 @@ using namespace std;
 #if defined(_MSC_VER)
   #include <malloc.h>
 #endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define LA_X86_DISPATCH 1
+  #include <immintrin.h>
+#endif
 
 static inline void* aligned_malloc(size_t bytes, size_t alignment = 64) {
 #if defined(_MSC_VER)
@@ -24,10 +28,14 @@ static inline void aligned_free(void* p) {
     std::free(p);
 #endif
 }
-static inline double* aligned_alloc_double(size_t count, size_t alignment = 64) {
-    void* p = aligned_malloc(count * sizeof(double), alignment);
+template<typename T>
+static inline T* aligned_alloc_array(size_t count, size_t alignment = 64) {
+    void* p = aligned_malloc(count * sizeof(T), alignment);
     if (!p) throw std::bad_alloc();
-    return static_cast<double*>(p);
+    return static_cast<T*>(p);
+}
+static inline double* aligned_alloc_double(size_t count, size_t alignment = 64) {
+    return aligned_alloc_array<double>(count, alignment);
 }
 
 using clock_t_ = std::chrono::high_resolution_clock;
@@ -63,6 +71,17 @@ static inline void fill_random(double* p, size_t n, uint64_t seed=42) {
     std::uniform_real_distribution<double> dist(-1.0, 1.0);
     for (size_t i=0;i<n;++i) p[i] = dist(rng);
 }
+// Worst element of x against a double reference, on the same scale nearly_equal uses
+template<typename T>
+static double max_rel_err(const T* x, const double* ref, size_t n) {
+    double worst = 0.0;
+    for (size_t i=0;i<n;++i) {
+        const double a = (double)x[i];
+        const double scale = std::max({1.0, std::abs(a), std::abs(ref[i])});
+        worst = std::max(worst, std::abs(a - ref[i]) / scale);
+    }
+    return worst;
+}
 
 // Matrix-Vector (row-major): y = A(rows x cols) * x
 void multiply_mv_row_major(const double* A, int rows, int cols,
@@ -84,6 +103,24 @@ void multiply_mv_row_major(const double* A, int rows, int cols,
     }
 }
 
+// Matrix-Vector (row-major), any precision: y = A * x with T products summed in Acc.
+// <double>, <float>, and <float, double> = float compute / double accumulate.
+// Eight independent partial sums let the compiler vectorize without reassociating.
+template<typename T, typename Acc = T>
+void multiply_mv_rm(const T* A, int rows, int cols, const T* x, Acc* y) {
+    if (!A || !x || !y || rows<=0 || cols<=0) return;
+    for (int i = 0; i < rows; ++i) {
+        const T* Ai = A + (size_t)i * cols;
+        Acc acc[8] = {};
+        int j=0;
+        for (; j+8<=cols; j+=8)
+            for (int u=0; u<8; ++u) acc[u] += (Acc)(Ai[j+u]*x[j+u]);
+        Acc s = ((acc[0]+acc[4]) + (acc[1]+acc[5])) + ((acc[2]+acc[6]) + (acc[3]+acc[7]));
+        for (; j<cols; ++j) s += (Acc)(Ai[j]*x[j]);
+        y[i] = s;
+    }
+}
+
 // Matrix-Vector (column-major A): y = A(rows x cols) * x
 void multiply_mv_col_major(const double* A, int rows, int cols,
                            const double* x, double* y) {
@@ -135,6 +172,144 @@ void transpose_rowmajor(const double* B, int rowsB, int colsB, double* B_T) {
             B_T[(size_t)c*rowsB + r] = B[(size_t)r*colsB + c];
 }
 
+// ================= Tiled transpose =================
+// 32x32 cache tiles (8 KB in + 8 KB out) walked as 4x4 register blocks: four row loads,
+// an in-register shuffle, four row stores, so both sides move whole 32-byte vectors
+// instead of one strided double at a time. Edge blocks fall back to scalar copies.
+static constexpr int kTransposeTile = 32;
+
+// transpose a rows x cols tile: dst(c, r) = src(r, c)
+using transpose_tile_t = void (*)(const double* src, size_t lds, double* dst, size_t ldd,
+                                  int rows, int cols);
+// in-place square matrix, tile pair: swap-transpose tile (i0, j0) with tile (j0, i0);
+// i0 == j0 transposes the diagonal tile in place
+using transpose_pair_t = void (*)(double* A, size_t ld, int i0, int j0, int rows, int cols);
+
+static inline void transpose_edge(const double* src, size_t lds, double* dst, size_t ldd,
+                                  int rows, int cols) {
+    for (int r=0; r<rows; ++r)
+        for (int c=0; c<cols; ++c) dst[(size_t)c*ldd + r] = src[(size_t)r*lds + c];
+}
+
+// block p (rows x cols at (bi, bj)) <-> block q (cols x rows at (bj, bi)); p == q on the diagonal
+static inline void swap_edge(double* p, double* q, size_t ld, int rows, int cols) {
+    for (int r=0; r<rows; ++r)
+        for (int c=0; c<cols; ++c) {
+            if (p == q && c <= r) continue;
+            std::swap(p[(size_t)r*ld + c], q[(size_t)c*ld + r]);
+        }
+}
+
+static void transpose_tile_generic(const double* src, size_t lds, double* dst, size_t ldd,
+                                   int rows, int cols) {
+    for (int bi=0; bi<rows; bi+=4)
+        for (int bj=0; bj<cols; bj+=4)
+            transpose_edge(src + (size_t)bi*lds + bj, lds, dst + (size_t)bj*ldd + bi, ldd,
+                           std::min(4, rows - bi), std::min(4, cols - bj));
+}
+
+static void transpose_pair_generic(double* A, size_t ld, int i0, int j0, int rows, int cols) {
+    for (int bi=0; bi<rows; bi+=4)
+        for (int bj=(i0 == j0 ? bi : 0); bj<cols; bj+=4)
+            swap_edge(A + (size_t)(i0+bi)*ld + j0 + bj, A + (size_t)(j0+bj)*ld + i0 + bi, ld,
+                      std::min(4, rows - bi), std::min(4, cols - bj));
+}
+
+#ifdef LA_X86_DISPATCH
+// rows r0..r3 = [a b c d] -> columns; unpack pairs, then swap 128-bit halves
+__attribute__((target("avx2")))
+static inline void transpose4x4_pd(__m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3) {
+    const __m256d t0 = _mm256_unpacklo_pd(r0, r1);   // a0 b0 a2 b2
+    const __m256d t1 = _mm256_unpackhi_pd(r0, r1);   // a1 b1 a3 b3
+    const __m256d t2 = _mm256_unpacklo_pd(r2, r3);   // c0 d0 c2 d2
+    const __m256d t3 = _mm256_unpackhi_pd(r2, r3);   // c1 d1 c3 d3
+    r0 = _mm256_permute2f128_pd(t0, t2, 0x20);        // a0 b0 c0 d0
+    r1 = _mm256_permute2f128_pd(t1, t3, 0x20);        // a1 b1 c1 d1
+    r2 = _mm256_permute2f128_pd(t0, t2, 0x31);        // a2 b2 c2 d2
+    r3 = _mm256_permute2f128_pd(t1, t3, 0x31);        // a3 b3 c3 d3
+}
+
+__attribute__((target("avx2")))
+static void transpose_tile_avx2(const double* src, size_t lds, double* dst, size_t ldd,
+                                int rows, int cols) {
+    // dst-row-major block order: consecutive stores extend the same 4 dst rows
+    for (int bj=0; bj<cols; bj+=4)
+        for (int bi=0; bi<rows; bi+=4) {
+            const double* s = src + (size_t)bi*lds + bj;
+            double* d = dst + (size_t)bj*ldd + bi;
+            if (rows - bi < 4 || cols - bj < 4) {
+                transpose_edge(s, lds, d, ldd, std::min(4, rows - bi), std::min(4, cols - bj));
+                continue;
+            }
+            __m256d r0 = _mm256_loadu_pd(s),         r1 = _mm256_loadu_pd(s + lds);
+            __m256d r2 = _mm256_loadu_pd(s + 2*lds), r3 = _mm256_loadu_pd(s + 3*lds);
+            transpose4x4_pd(r0, r1, r2, r3);
+            _mm256_storeu_pd(d, r0);         _mm256_storeu_pd(d + ldd, r1);
+            _mm256_storeu_pd(d + 2*ldd, r2); _mm256_storeu_pd(d + 3*ldd, r3);
+        }
+}
+
+__attribute__((target("avx2")))
+static void transpose_pair_avx2(double* A, size_t ld, int i0, int j0, int rows, int cols) {
+    for (int bi=0; bi<rows; bi+=4)
+        for (int bj=(i0 == j0 ? bi : 0); bj<cols; bj+=4) {
+            double* p = A + (size_t)(i0+bi)*ld + j0 + bj;
+            double* q = A + (size_t)(j0+bj)*ld + i0 + bi;
+            if (rows - bi < 4 || cols - bj < 4) {
+                swap_edge(p, q, ld, std::min(4, rows - bi), std::min(4, cols - bj));
+                continue;
+            }
+            // both blocks are in registers before either is stored, so p == q is fine
+            __m256d p0 = _mm256_loadu_pd(p),        p1 = _mm256_loadu_pd(p + ld);
+            __m256d p2 = _mm256_loadu_pd(p + 2*ld), p3 = _mm256_loadu_pd(p + 3*ld);
+            __m256d q0 = _mm256_loadu_pd(q),        q1 = _mm256_loadu_pd(q + ld);
+            __m256d q2 = _mm256_loadu_pd(q + 2*ld), q3 = _mm256_loadu_pd(q + 3*ld);
+            transpose4x4_pd(p0, p1, p2, p3);
+            transpose4x4_pd(q0, q1, q2, q3);
+            _mm256_storeu_pd(q, p0);        _mm256_storeu_pd(q + ld, p1);
+            _mm256_storeu_pd(q + 2*ld, p2); _mm256_storeu_pd(q + 3*ld, p3);
+            _mm256_storeu_pd(p, q0);        _mm256_storeu_pd(p + ld, q1);
+            _mm256_storeu_pd(p + 2*ld, q2); _mm256_storeu_pd(p + 3*ld, q3);
+        }
+}
+#endif
+
+static bool transpose_use_avx2() {
+#ifdef LA_X86_DISPATCH
+    static const bool ok = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return ok;
+#else
+    return false;
+#endif
+}
+
+// Same contract as transpose_rowmajor: B (rowsB x colsB) -> B_T (colsB x rowsB), row-major
+void transpose_tiled(const double* B, int rowsB, int colsB, double* B_T) {
+    if (!B || !B_T || rowsB<=0 || colsB<=0) return;
+    transpose_tile_t tile = transpose_tile_generic;
+#ifdef LA_X86_DISPATCH
+    if (transpose_use_avx2()) tile = transpose_tile_avx2;
+#endif
+    const int T = kTransposeTile;
+    for (int i0=0; i0<rowsB; i0+=T)
+        for (int j0=0; j0<colsB; j0+=T)
+            tile(B + (size_t)i0*colsB + j0, (size_t)colsB, B_T + (size_t)j0*rowsB + i0, (size_t)rowsB,
+                 std::min(T, rowsB - i0), std::min(T, colsB - j0));
+}
+
+// In-place transpose of a square n x n row-major matrix (upper tile pairs only)
+void transpose_inplace_square(double* A, int n) {
+    if (!A || n<=0) return;
+    transpose_pair_t pair = transpose_pair_generic;
+#ifdef LA_X86_DISPATCH
+    if (transpose_use_avx2()) pair = transpose_pair_avx2;
+#endif
+    const int T = kTransposeTile;
+    for (int i0=0; i0<n; i0+=T)
+        for (int j0=i0; j0<n; j0+=T)
+            pair(A, (size_t)n, i0, j0, std::min(T, n - i0), std::min(T, n - j0));
+}
+
 // Matrix-Matrix with transposed B: C = A(MxK) * B_T(NxK)^T
 void multiply_mm_transposed_b(const double* A, int M, int K,
                               const double* B_T, int K2, int N,
@@ -164,7 +339,7 @@ void multiply_mm_blocked(const double* A, int M, int K,
     std::memset(C, 0, sizeof(double) * (size_t)M*N);
 
     unique_ptr<double[]> BT(new double[(size_t)N*K]);
-    transpose_rowmajor(B, K, N, BT.get());
+    transpose_tiled(B, K, N, BT.get());
 
     for (int i0=0; i0<M; i0+=blockM) {
         int iMax = std::min(i0 + blockM, M);
@@ -198,6 +373,856 @@ void multiply_mm_blocked(const double* A, int M, int K,
     }
 }
 
+// ================= Packed GEMM engine =================
+// C = A(MxK) * B(KxN), all row-major, same signature as the kernels above.
+// Goto/BLIS loop order:
+//   jc: NC columns of B -> packed B panel (KC x NC), lives in L3
+//   pc: KC depth        -> packed A block (MC x KC), lives in L2
+//   ic: MC rows of A
+//   jr/ir: MR x NR micro-tiles; one KC x NR sliver of B stays in L1
+// The micro-kernel keeps the whole MR x NR tile of C in vector registers and only
+// touches C once per KC block. Packing pads edge panels with zeros, so the kernel
+// always runs full tiles; partial tiles go through a small buffer.
+// The engine is templated on the element type: float kernels have twice the lanes
+// per register, so their tiles are twice as wide.
+
+// ukr(kc, Ap, Bp, C, ldc, accumulate): C[MR x NR] (+)= sum_p Ap[p][0..MR) x Bp[p][0..NR)
+template<typename T>
+using gemm_ukr_fn = void (*)(int kc, const T* Ap, const T* Bp,
+                             T* C, size_t ldc, bool accumulate);
+using gemm_ukr_t = gemm_ukr_fn<double>;
+
+template<typename T>
+struct GemmKernelT {
+    const char* name;
+    int mr, nr;        // register tile
+    int mc, kc, nc;    // cache blocks, mc % mr == 0 and nc % nr == 0
+    gemm_ukr_fn<T> ukr;
+};
+using GemmKernel    = GemmKernelT<double>;
+using GemmKernelF32 = GemmKernelT<float>;
+
+static constexpr int kGemmMaxTile = 8*48; // largest mr*nr below
+
+template<typename T, int MR, int NR>
+static void gemm_ukr_generic(int kc, const T* Ap, const T* Bp,
+                             T* C, size_t ldc, bool accumulate) {
+    T acc[MR][NR] = {};
+    for (int p=0; p<kc; ++p) {
+        for (int r=0; r<MR; ++r) {
+            const T a = Ap[r];
+            for (int c=0; c<NR; ++c) acc[r][c] += a * Bp[c];
+        }
+        Ap += MR; Bp += NR;
+    }
+    for (int r=0; r<MR; ++r)
+        for (int c=0; c<NR; ++c)
+            C[r*ldc + c] = accumulate ? C[r*ldc + c] + acc[r][c] : acc[r][c];
+}
+
+#ifdef LA_X86_DISPATCH
+// 6x8: 12 ymm accumulators + 2 B vectors + 1 broadcast = 15 of 16 registers
+__attribute__((target("avx2,fma")))
+static void gemm_ukr_avx2_6x8(int kc, const double* Ap, const double* Bp,
+                              double* C, size_t ldc, bool accumulate) {
+    __m256d c[6][2];
+    #pragma GCC unroll 6
+    for (int r=0; r<6; ++r) c[r][0] = c[r][1] = _mm256_setzero_pd();
+    for (int p=0; p<kc; ++p) {
+        const __m256d b0 = _mm256_loadu_pd(Bp);
+        const __m256d b1 = _mm256_loadu_pd(Bp + 4);
+        #pragma GCC unroll 6
+        for (int r=0; r<6; ++r) {
+            const __m256d a = _mm256_broadcast_sd(Ap + r);
+            c[r][0] = _mm256_fmadd_pd(a, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_pd(a, b1, c[r][1]);
+        }
+        Ap += 6; Bp += 8;
+    }
+    #pragma GCC unroll 6
+    for (int r=0; r<6; ++r) {
+        double* Cr = C + r*ldc;
+        if (accumulate) {
+            c[r][0] = _mm256_add_pd(c[r][0], _mm256_loadu_pd(Cr));
+            c[r][1] = _mm256_add_pd(c[r][1], _mm256_loadu_pd(Cr + 4));
+        }
+        _mm256_storeu_pd(Cr,     c[r][0]);
+        _mm256_storeu_pd(Cr + 4, c[r][1]);
+    }
+}
+
+// 8x24: 24 zmm accumulators + 3 B vectors + 1 broadcast = 28 of 32 registers
+__attribute__((target("avx512f")))
+static void gemm_ukr_avx512_8x24(int kc, const double* Ap, const double* Bp,
+                                 double* C, size_t ldc, bool accumulate) {
+    __m512d c[8][3];
+    #pragma GCC unroll 8
+    for (int r=0; r<8; ++r) c[r][0] = c[r][1] = c[r][2] = _mm512_setzero_pd();
+    for (int p=0; p<kc; ++p) {
+        const __m512d b0 = _mm512_loadu_pd(Bp);
+        const __m512d b1 = _mm512_loadu_pd(Bp + 8);
+        const __m512d b2 = _mm512_loadu_pd(Bp + 16);
+        #pragma GCC unroll 8
+        for (int r=0; r<8; ++r) {
+            const __m512d a = _mm512_set1_pd(Ap[r]);
+            c[r][0] = _mm512_fmadd_pd(a, b0, c[r][0]);
+            c[r][1] = _mm512_fmadd_pd(a, b1, c[r][1]);
+            c[r][2] = _mm512_fmadd_pd(a, b2, c[r][2]);
+        }
+        Ap += 8; Bp += 24;
+    }
+    #pragma GCC unroll 8
+    for (int r=0; r<8; ++r) {
+        double* Cr = C + r*ldc;
+        if (accumulate) {
+            c[r][0] = _mm512_add_pd(c[r][0], _mm512_loadu_pd(Cr));
+            c[r][1] = _mm512_add_pd(c[r][1], _mm512_loadu_pd(Cr + 8));
+            c[r][2] = _mm512_add_pd(c[r][2], _mm512_loadu_pd(Cr + 16));
+        }
+        _mm512_storeu_pd(Cr,      c[r][0]);
+        _mm512_storeu_pd(Cr + 8,  c[r][1]);
+        _mm512_storeu_pd(Cr + 16, c[r][2]);
+    }
+}
+
+// float 6x16: same register budget as avx2-6x8, 8 lanes per ymm
+__attribute__((target("avx2,fma")))
+static void gemm_ukr_avx2_6x16_f32(int kc, const float* Ap, const float* Bp,
+                                   float* C, size_t ldc, bool accumulate) {
+    __m256 c[6][2];
+    #pragma GCC unroll 6
+    for (int r=0; r<6; ++r) c[r][0] = c[r][1] = _mm256_setzero_ps();
+    for (int p=0; p<kc; ++p) {
+        const __m256 b0 = _mm256_loadu_ps(Bp);
+        const __m256 b1 = _mm256_loadu_ps(Bp + 8);
+        #pragma GCC unroll 6
+        for (int r=0; r<6; ++r) {
+            const __m256 a = _mm256_broadcast_ss(Ap + r);
+            c[r][0] = _mm256_fmadd_ps(a, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_ps(a, b1, c[r][1]);
+        }
+        Ap += 6; Bp += 16;
+    }
+    #pragma GCC unroll 6
+    for (int r=0; r<6; ++r) {
+        float* Cr = C + r*ldc;
+        if (accumulate) {
+            c[r][0] = _mm256_add_ps(c[r][0], _mm256_loadu_ps(Cr));
+            c[r][1] = _mm256_add_ps(c[r][1], _mm256_loadu_ps(Cr + 8));
+        }
+        _mm256_storeu_ps(Cr,     c[r][0]);
+        _mm256_storeu_ps(Cr + 8, c[r][1]);
+    }
+}
+
+// float 8x48: same register budget as avx512-8x24, 16 lanes per zmm
+__attribute__((target("avx512f")))
+static void gemm_ukr_avx512_8x48_f32(int kc, const float* Ap, const float* Bp,
+                                     float* C, size_t ldc, bool accumulate) {
+    __m512 c[8][3];
+    #pragma GCC unroll 8
+    for (int r=0; r<8; ++r) c[r][0] = c[r][1] = c[r][2] = _mm512_setzero_ps();
+    for (int p=0; p<kc; ++p) {
+        const __m512 b0 = _mm512_loadu_ps(Bp);
+        const __m512 b1 = _mm512_loadu_ps(Bp + 16);
+        const __m512 b2 = _mm512_loadu_ps(Bp + 32);
+        #pragma GCC unroll 8
+        for (int r=0; r<8; ++r) {
+            const __m512 a = _mm512_set1_ps(Ap[r]);
+            c[r][0] = _mm512_fmadd_ps(a, b0, c[r][0]);
+            c[r][1] = _mm512_fmadd_ps(a, b1, c[r][1]);
+            c[r][2] = _mm512_fmadd_ps(a, b2, c[r][2]);
+        }
+        Ap += 8; Bp += 48;
+    }
+    #pragma GCC unroll 8
+    for (int r=0; r<8; ++r) {
+        float* Cr = C + r*ldc;
+        if (accumulate) {
+            c[r][0] = _mm512_add_ps(c[r][0], _mm512_loadu_ps(Cr));
+            c[r][1] = _mm512_add_ps(c[r][1], _mm512_loadu_ps(Cr + 16));
+            c[r][2] = _mm512_add_ps(c[r][2], _mm512_loadu_ps(Cr + 32));
+        }
+        _mm512_storeu_ps(Cr,      c[r][0]);
+        _mm512_storeu_ps(Cr + 16, c[r][1]);
+        _mm512_storeu_ps(Cr + 32, c[r][2]);
+    }
+}
+#endif
+
+// Block sizes: B sliver (kc*nr) + A sliver (kc*mr) fit L1, A block (mc*kc) about half of L2
+static const GemmKernel kGemmGeneric = { "generic-4x4", 4, 4,  64, 256, 4080, gemm_ukr_generic<double,4,4> };
+static const GemmKernelF32 kGemmGenericF32 = { "generic-4x8-f32", 4, 8, 64, 256, 4080, gemm_ukr_generic<float,4,8> };
+#ifdef LA_X86_DISPATCH
+static const GemmKernel kGemmAvx2    = { "avx2-6x8",    6, 8,  96, 256, 4080, gemm_ukr_avx2_6x8 };
+static const GemmKernel kGemmAvx512  = { "avx512-8x24", 8, 24, 144, 192, 4080, gemm_ukr_avx512_8x24 };
+static const GemmKernelF32 kGemmAvx2F32   = { "avx2-6x16-f32",   6, 16, 96, 256, 4080, gemm_ukr_avx2_6x16_f32 };
+static const GemmKernelF32 kGemmAvx512F32 = { "avx512-8x48-f32", 8, 48, 144, 192, 4080, gemm_ukr_avx512_8x48_f32 };
+#endif
+
+// Picked once from CPUID; LA_GEMM_KERNEL=generic|avx2|avx512 forces a (supported) one.
+// The same choice applies to the double and the float engine.
+template<typename T>
+static const GemmKernelT<T>& select_gemm_kernel(const GemmKernelT<T>& generic,
+                                                const GemmKernelT<T>* avx2,
+                                                const GemmKernelT<T>* avx512) {
+    const char* force = std::getenv("LA_GEMM_KERNEL");
+    const string want = force ? force : "";
+#ifdef LA_X86_DISPATCH
+    __builtin_cpu_init();
+    const bool has512 = __builtin_cpu_supports("avx512f");
+    const bool has2   = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (want == "generic") return generic;
+    if (want == "avx2" && has2) return *avx2;
+    if ((want.empty() || want == "avx512") && has512) return *avx512;
+    if (has2) return *avx2;
+#else
+    (void)want; (void)avx2; (void)avx512;
+#endif
+    return generic;
+}
+static const GemmKernel& gemm_kernel() {
+#ifdef LA_X86_DISPATCH
+    static const GemmKernel& k = select_gemm_kernel(kGemmGeneric, &kGemmAvx2, &kGemmAvx512);
+#else
+    static const GemmKernel& k = select_gemm_kernel<double>(kGemmGeneric, nullptr, nullptr);
+#endif
+    return k;
+}
+static const GemmKernelF32& gemm_kernel_f32() {
+#ifdef LA_X86_DISPATCH
+    static const GemmKernelF32& k = select_gemm_kernel(kGemmGenericF32, &kGemmAvx2F32, &kGemmAvx512F32);
+#else
+    static const GemmKernelF32& k = select_gemm_kernel<float>(kGemmGenericF32, nullptr, nullptr);
+#endif
+    return k;
+}
+
+// A block (mc x kc) -> mr-row panels, each stored k-major: Ap[p*mr + r]
+template<typename T>
+static void pack_a(const T* A, size_t lda, int mc, int kc, int mr, T* Ap) {
+    for (int i=0; i<mc; i+=mr) {
+        const int m = std::min(mr, mc - i);
+        for (int p=0; p<kc; ++p) {
+            for (int r=0; r<m; ++r)  Ap[r] = A[(size_t)(i+r)*lda + p];
+            for (int r=m; r<mr; ++r) Ap[r] = T(0);
+            Ap += mr;
+        }
+    }
+}
+
+// B panel (kc x nc) -> nr-column slivers, each stored k-major: Bp[p*nr + c]
+template<typename T>
+static void pack_b(const T* B, size_t ldb, int kc, int nc, int nr, T* Bp) {
+    for (int j=0; j<nc; j+=nr) {
+        const int n = std::min(nr, nc - j);
+        for (int p=0; p<kc; ++p) {
+            const T* src = B + (size_t)p*ldb + j;
+            for (int c=0; c<n; ++c)  Bp[c] = src[c];
+            for (int c=n; c<nr; ++c) Bp[c] = T(0);
+            Bp += nr;
+        }
+    }
+}
+
+// Packing buffers for one thread; fit() only reallocates when a kernel needs bigger blocks
+template<typename T>
+struct GemmWorkspaceT {
+    unique_ptr<T, void(*)(void*)> Ap{nullptr, aligned_free}, Bp{nullptr, aligned_free};
+    size_t a_cap = 0, b_cap = 0;
+    void fit(const GemmKernelT<T>& g) {
+        const size_t a = (size_t)g.mc*g.kc, b = (size_t)g.kc*g.nc;
+        if (a > a_cap) { Ap.reset(aligned_alloc_array<T>(a)); a_cap = a; }
+        if (b > b_cap) { Bp.reset(aligned_alloc_array<T>(b)); b_cap = b; }
+    }
+};
+using GemmWorkspace    = GemmWorkspaceT<double>;
+using GemmWorkspaceF32 = GemmWorkspaceT<float>;
+
+// The calling thread's workspace, kept for the life of the thread. The B panel is several
+// MB, so allocating (and page-faulting) it per call showed up in small and threaded
+// GEMMs; the pool's workers are persistent, so each keeps its buffers warm across calls.
+template<typename T>
+static GemmWorkspaceT<T>& thread_gemm_workspace(const GemmKernelT<T>& g) {
+    thread_local GemmWorkspaceT<T> ws;
+    ws.fit(g);
+    return ws;
+}
+
+// Float partial sums with a double C run this many k steps before they are added in
+static constexpr int kGemmMixedFlush = 64;
+
+// C(MxN, ldc) = A(MxK, lda) * B(KxN, ldb) on a sub-block; the serial and threaded
+// drivers both end up here. With T == TC full tiles go straight to C and only partial
+// tiles use the edge buffer. With a wider TC (float in, double C) the T kernel runs
+// kGemmMixedFlush k steps at a time into the buffer and each partial tile is added into
+// C in TC, so float rounding grows with the flush length rather than with K.
+template<typename T, typename TC>
+static void gemm_packed_block(const T* A, size_t lda, const T* B, size_t ldb,
+                              TC* C, size_t ldc, int M, int K, int N,
+                              const GemmKernelT<T>& g, GemmWorkspaceT<T>& ws) {
+    const int MR = g.mr, NR = g.nr;
+    alignas(64) T edge[kGemmMaxTile];
+    auto store_edge = [&](TC* Ct, int mr, int nr, bool acc) {
+        for (int r=0; r<mr; ++r)
+            for (int c=0; c<nr; ++c)
+                Ct[(size_t)r*ldc + c] = acc ? Ct[(size_t)r*ldc + c] + (TC)edge[r*NR + c]
+                                            : (TC)edge[r*NR + c];
+    };
+
+    for (int jc=0; jc<N; jc+=g.nc) {
+        const int nc = std::min(g.nc, N - jc);
+        for (int pc=0; pc<K; pc+=g.kc) {
+            const int kc = std::min(g.kc, K - pc);
+            const bool acc = pc > 0;           // first KC block overwrites C
+            pack_b(B + (size_t)pc*ldb + jc, ldb, kc, nc, NR, ws.Bp.get());
+            for (int ic=0; ic<M; ic+=g.mc) {
+                const int mc = std::min(g.mc, M - ic);
+                pack_a(A + (size_t)ic*lda + pc, lda, mc, kc, MR, ws.Ap.get());
+                for (int jr=0; jr<nc; jr+=NR) {
+                    const int nr = std::min(NR, nc - jr);
+                    const T* Bs = ws.Bp.get() + (size_t)jr*kc;
+                    for (int ir=0; ir<mc; ir+=MR) {
+                        const int mr = std::min(MR, mc - ir);
+                        const T* As = ws.Ap.get() + (size_t)ir*kc;
+                        TC* Ct = C + (size_t)(ic+ir)*ldc + jc + jr;
+                        if constexpr (std::is_same_v<T, TC>) {
+                            if (mr == MR && nr == NR) {
+                                g.ukr(kc, As, Bs, Ct, ldc, acc);
+                                continue;
+                            }
+                            g.ukr(kc, As, Bs, edge, (size_t)NR, false);
+                            store_edge(Ct, mr, nr, acc);
+                        } else {
+                            for (int p=0; p<kc; p+=kGemmMixedFlush) {
+                                const int kp = std::min(kGemmMixedFlush, kc - p);
+                                g.ukr(kp, As + (size_t)p*MR, Bs + (size_t)p*NR, edge, (size_t)NR, false);
+                                store_edge(Ct, mr, nr, acc || p > 0);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void multiply_mm_packed(const double* A, int M, int K,
+                        const double* B, int K2, int N,
+                        double* C, const GemmKernel& g = gemm_kernel()) {
+    if (!A || !B || !C || M<=0 || K<=0 || N<=0 || K!=K2) return;
+    gemm_packed_block(A, (size_t)K, B, (size_t)N, C, (size_t)N, M, K, N, g, thread_gemm_workspace(g));
+}
+
+// float32: twice the lanes per register and half the bytes per element
+void multiply_mm_packed(const float* A, int M, int K,
+                        const float* B, int K2, int N,
+                        float* C, const GemmKernelF32& g = gemm_kernel_f32()) {
+    if (!A || !B || !C || M<=0 || K<=0 || N<=0 || K!=K2) return;
+    gemm_packed_block(A, (size_t)K, B, (size_t)N, C, (size_t)N, M, K, N, g, thread_gemm_workspace(g));
+}
+
+// float32 compute, double accumulate: the float kernels, with every kGemmMixedFlush
+// k steps of each tile added into the double C
+void multiply_mm_packed(const float* A, int M, int K,
+                        const float* B, int K2, int N,
+                        double* C, const GemmKernelF32& g = gemm_kernel_f32()) {
+    if (!A || !B || !C || M<=0 || K<=0 || N<=0 || K!=K2) return;
+    gemm_packed_block(A, (size_t)K, B, (size_t)N, C, (size_t)N, M, K, N, g, thread_gemm_workspace(g));
+}
+
+// ================= Matrix type =================
+// Owning Matrix<T, Layout> and non-owning MatrixView<T, Layout>. The layout is a tag
+// type, so a row-major matrix can't be passed where a column-major one is expected and
+// the kernel is chosen at compile time. Storage is 64-byte aligned and the leading
+// dimension is padded (see padded_ld); views can be strided sub-blocks.
+struct RowMajor {};
+struct ColMajor {};
+
+// Leading dimension in elements: rounded up to a full 64-byte line, plus one more line
+// when the pitch is a multiple of 512 bytes. Without that, power-of-two sizes (1024,
+// 2048, ...) put every row on the same L1 sets and 4K-alias in the load/store unit.
+template<typename T>
+static size_t padded_ld(size_t n) {
+    const size_t line = 64 / sizeof(T);
+    size_t ld = (n + line - 1) / line * line;
+    if ((ld * sizeof(T)) % 512 == 0) ld += line;
+    return ld;
+}
+
+template<typename T, typename Layout = RowMajor>
+class MatrixView {
+public:
+    using layout = Layout;
+    static constexpr bool row_major = std::is_same<Layout, RowMajor>::value;
+
+    MatrixView(T* data, int rows, int cols, size_t ld)
+        : data_(data), rows_(rows), cols_(cols), ld_(ld) {}
+
+    T*     data() const { return data_; }
+    int    rows() const { return rows_; }
+    int    cols() const { return cols_; }
+    size_t ld()   const { return ld_; }
+
+    T& operator()(int i, int j) const {
+        return row_major ? data_[(size_t)i*ld_ + j] : data_[(size_t)j*ld_ + i];
+    }
+
+    // rows x cols window starting at (i, j); shares storage and ld
+    MatrixView block(int i, int j, int rows, int cols) const {
+        return MatrixView(&(*this)(i, j), rows, cols, ld_);
+    }
+
+    operator MatrixView<const T, Layout>() const { return {data_, rows_, cols_, ld_}; }
+
+private:
+    T*     data_;
+    int    rows_, cols_;
+    size_t ld_;
+};
+
+template<typename T, typename Layout = RowMajor>
+class Matrix {
+public:
+    static constexpr bool row_major = std::is_same<Layout, RowMajor>::value;
+
+    Matrix(int rows, int cols)
+        : rows_(rows), cols_(cols),
+          ld_(padded_ld<T>((size_t)(row_major ? cols : rows))),
+          data_(static_cast<T*>(aligned_malloc(sizeof(T) * ld_ * (size_t)(row_major ? rows : cols))),
+                aligned_free) {
+        if (!data_) throw std::bad_alloc();
+        std::memset(data_.get(), 0, sizeof(T) * ld_ * (size_t)(row_major ? rows : cols)); // padding stays 0
+    }
+
+    T*       data()       { return data_.get(); }
+    const T* data() const { return data_.get(); }
+    int    rows() const { return rows_; }
+    int    cols() const { return cols_; }
+    size_t ld()   const { return ld_; }
+
+    T&       operator()(int i, int j)       { return view()(i, j); }
+    const T& operator()(int i, int j) const { return view()(i, j); }
+
+    MatrixView<T, Layout>       view()       { return {data_.get(), rows_, cols_, ld_}; }
+    MatrixView<const T, Layout> view() const { return {data_.get(), rows_, cols_, ld_}; }
+
+private:
+    int    rows_, cols_;
+    size_t ld_;
+    unique_ptr<T, void(*)(void*)> data_;
+};
+
+// y = A * x; row-major runs dot products along rows, column-major runs axpy down columns
+template<typename TA, typename LA>
+void multiply_mv(MatrixView<TA, LA> A, const double* x, double* y) {
+    const int rows = A.rows(), cols = A.cols();
+    if (!A.data() || !x || !y || rows<=0 || cols<=0) return;
+    if constexpr (MatrixView<TA, LA>::row_major) {
+        for (int i=0; i<rows; ++i) {
+            const double* Ai = A.data() + (size_t)i*A.ld();
+            double acc = 0.0;
+            int j=0;
+            for (; j+4<=cols; j+=4) acc += Ai[j]*x[j] + Ai[j+1]*x[j+1] + Ai[j+2]*x[j+2] + Ai[j+3]*x[j+3];
+            for (; j<cols; ++j) acc += Ai[j]*x[j];
+            y[i] = acc;
+        }
+    } else {
+        std::memset(y, 0, sizeof(double) * (size_t)rows);
+        for (int j=0; j<cols; ++j) {
+            const double* Aj = A.data() + (size_t)j*A.ld();
+            const double xj = x[j];
+            for (int i=0; i<rows; ++i) y[i] += Aj[i]*xj;
+        }
+    }
+}
+
+// C = A * B, kernel picked from the three layouts:
+//   row x row -> row : packed GEMM (honours every ld)
+//   row x col -> row : B is B^T row-major, contiguous dot products
+//   anything else    : ikj loop through operator()
+template<typename TA, typename LA, typename TB, typename LB, typename LC>
+void multiply_mm(MatrixView<TA, LA> A, MatrixView<TB, LB> B, MatrixView<double, LC> C) {
+    const int M = A.rows(), K = A.cols(), N = B.cols();
+    if (!A.data() || !B.data() || !C.data() || M<=0 || K<=0 || N<=0) return;
+    if (B.rows() != K || C.rows() != M || C.cols() != N) return;
+    constexpr bool a_row = MatrixView<TA, LA>::row_major;
+    constexpr bool b_row = MatrixView<TB, LB>::row_major;
+    constexpr bool c_row = MatrixView<double, LC>::row_major;
+
+    if constexpr (a_row && b_row && c_row) {
+        const GemmKernel& g = gemm_kernel();
+        gemm_packed_block(A.data(), A.ld(), B.data(), B.ld(), C.data(), C.ld(), M, K, N, g,
+                          thread_gemm_workspace(g));
+    } else if constexpr (a_row && !b_row && c_row) {
+        for (int i=0; i<M; ++i) {
+            const double* Ai = A.data() + (size_t)i*A.ld();
+            double* Ci = C.data() + (size_t)i*C.ld();
+            for (int j=0; j<N; ++j) {
+                const double* Bj = B.data() + (size_t)j*B.ld();
+                double acc = 0.0;
+                int k=0;
+                for (; k+4<=K; k+=4) acc += Ai[k]*Bj[k] + Ai[k+1]*Bj[k+1] + Ai[k+2]*Bj[k+2] + Ai[k+3]*Bj[k+3];
+                for (; k<K; ++k) acc += Ai[k]*Bj[k];
+                Ci[j] = acc;
+            }
+        }
+    } else {
+        for (int i=0; i<M; ++i) for (int j=0; j<N; ++j) C(i, j) = 0.0;
+        for (int i=0; i<M; ++i)
+            for (int k=0; k<K; ++k) {
+                const double aik = A(i, k);
+                for (int j=0; j<N; ++j) C(i, j) += aik * B(k, j);
+            }
+    }
+}
+
+template<typename LA>
+void multiply_mv(const Matrix<double, LA>& A, const double* x, double* y) {
+    multiply_mv(A.view(), x, y);
+}
+template<typename LA, typename LB, typename LC>
+void multiply_mm(const Matrix<double, LA>& A, const Matrix<double, LB>& B, Matrix<double, LC>& C) {
+    multiply_mm(A.view(), B.view(), C.view());
+}
+
+// ================= Small fixed-size kernels =================
+// Shapes known at compile time (per-instrument 4x4 .. 16x16 blocks): the k/j loops have
+// constant trip counts, so they unroll completely and each C row stays in registers.
+// No size checks, no remainder loops, no temporaries. The row loop is left rolled:
+// unrolling it too (16x16x16 = 4096 FMAs) spills and was slower.
+template<int M, int K, int N>
+static inline void multiply_mm_small(const double* __restrict A, const double* __restrict B,
+                                     double* __restrict C) {
+    for (int i=0; i<M; ++i) {
+        double c[N] = {};
+        #pragma GCC unroll 16
+        for (int k=0; k<K; ++k) {
+            const double aik = A[i*K + k];
+            #pragma GCC unroll 16
+            for (int j=0; j<N; ++j) c[j] += aik * B[k*N + j];
+        }
+        #pragma GCC unroll 16
+        for (int j=0; j<N; ++j) C[i*N + j] = c[j];
+    }
+}
+
+template<int M, int N>
+static inline void multiply_mv_small(const double* __restrict A, const double* __restrict x,
+                                     double* __restrict y) {
+    for (int i=0; i<M; ++i) {
+        double acc = 0.0;
+        for (int j=0; j<N; ++j) acc += A[i*N + j] * x[j];
+        y[i] = acc;
+    }
+}
+
+// Batched: `count` independent products over contiguous buffers, item b at
+// A + b*M*K, B + b*K*N, C + b*M*N
+template<int M, int K, int N>
+void batched_mm_small(const double* A, const double* B, double* C, size_t count) {
+    for (size_t b=0; b<count; ++b)
+        multiply_mm_small<M,K,N>(A + b*(M*K), B + b*(K*N), C + b*(M*N));
+}
+
+// y_b = A_b * x_b, item b at A + b*M*N, x + b*N, y + b*M
+template<int M, int N>
+void batched_mv_small(const double* A, const double* x, double* y, size_t count) {
+    for (size_t b=0; b<count; ++b)
+        multiply_mv_small<M,N>(A + b*(M*N), x + b*N, y + b*M);
+}
+
+// Square n x n batches with n picked at runtime: the common block sizes go to the
+// specialised kernels, anything else to the generic blocked kernel. false = not specialised.
+bool batched_mm_square(int n, const double* A, const double* B, double* C, size_t count) {
+    switch (n) {
+        case 4:  batched_mm_small<4,4,4>(A, B, C, count);     return true;
+        case 6:  batched_mm_small<6,6,6>(A, B, C, count);     return true;
+        case 8:  batched_mm_small<8,8,8>(A, B, C, count);     return true;
+        case 12: batched_mm_small<12,12,12>(A, B, C, count);  return true;
+        case 16: batched_mm_small<16,16,16>(A, B, C, count);  return true;
+    }
+    const size_t nn = (size_t)n*n;
+    for (size_t b=0; b<count; ++b) multiply_mm_blocked(A + b*nn, n, n, B + b*nn, n, n, C + b*nn);
+    return false;
+}
+
+bool batched_mv_square(int n, const double* A, const double* x, double* y, size_t count) {
+    switch (n) {
+        case 4:  batched_mv_small<4,4>(A, x, y, count);    return true;
+        case 6:  batched_mv_small<6,6>(A, x, y, count);    return true;
+        case 8:  batched_mv_small<8,8>(A, x, y, count);    return true;
+        case 12: batched_mv_small<12,12>(A, x, y, count);  return true;
+        case 16: batched_mv_small<16,16>(A, x, y, count);  return true;
+    }
+    for (size_t b=0; b<count; ++b) multiply_mv_row_major(A + b*n*n, n, n, x + b*n, y + b*n);
+    return false;
+}
+
+// ================= Thread pool =================
+// Persistent workers (Linux: build with -pthread). run(f) calls f(tid) once on every
+// thread, tid 0 being the caller, and returns when all have finished. Kernels split
+// their work statically by tid, so the same thread always gets the same rows.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) : n_(std::max(1, threads)) {
+        for (int t=1; t<n_; ++t) workers_.emplace_back([this, t]{ worker(t); });
+    }
+    ~ThreadPool() {
+        { lock_guard<mutex> lk(m_); stop_ = true; ++gen_; }
+        wake_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return n_; }
+
+    void run(const function<void(int)>& f) {
+        if (n_ == 1) { f(0); return; }
+        { lock_guard<mutex> lk(m_); job_ = &f; pending_ = n_ - 1; ++gen_; }
+        wake_.notify_all();
+        f(0);
+        unique_lock<mutex> lk(m_);
+        done_.wait(lk, [&]{ return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void worker(int tid) {
+        uint64_t seen = 0;
+        for (;;) {
+            const function<void(int)>* job;
+            {
+                unique_lock<mutex> lk(m_);
+                wake_.wait(lk, [&]{ return gen_ != seen; });
+                seen = gen_;
+                if (stop_) return;
+                job = job_;
+            }
+            (*job)(tid);
+            lock_guard<mutex> lk(m_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    int n_;
+    vector<thread> workers_;
+    mutex m_;
+    condition_variable wake_, done_;
+    const function<void(int)>* job_ = nullptr;
+    int pending_ = 0;
+    uint64_t gen_ = 0;
+    bool stop_ = false;
+};
+
+// [lo, hi) of part t out of T, edges rounded to multiples of `align`
+static inline void split_range(size_t n, int T, int t, size_t align, size_t& lo, size_t& hi) {
+    const size_t blocks = (n + align - 1) / align;
+    lo = std::min(n, blocks * t / T * align);
+    hi = std::min(n, blocks * (t + 1) / T * align);
+}
+
+// Zero p[0..n) with each thread writing its own contiguous share. On NUMA machines the
+// first write places a page, so the rows a thread later works on live on its node.
+static void first_touch(ThreadPool& pool, double* p, size_t n) {
+    pool.run([&](int t) {
+        size_t lo, hi;
+        split_range(n, pool.size(), t, 512, lo, hi); // 4 KB pages
+        if (hi > lo) std::memset(p + lo, 0, sizeof(double) * (hi - lo));
+    });
+}
+
+// GEMV over row blocks: each thread owns y[lo..hi) (cache-line aligned edges)
+void multiply_mv_row_major_mt(ThreadPool& pool, const double* A, int rows, int cols,
+                              const double* x, double* y) {
+    if (!A || !x || !y || rows<=0 || cols<=0) return;
+    pool.run([&](int t) {
+        size_t lo, hi;
+        split_range((size_t)rows, pool.size(), t, 8, lo, hi);
+        if (hi > lo) multiply_mv_row_major(A + lo*cols, (int)(hi - lo), cols, x, y + lo);
+    });
+}
+
+// GEMM over M/N macro-tiles. Tiles are numbered row-major and each thread takes one
+// contiguous range, so a thread mostly owns whole row bands of A and C (matches
+// first_touch). Every thread packs its own panels into its persistent workspace.
+void multiply_mm_packed_mt(ThreadPool& pool, const double* A, int M, int K,
+                           const double* B, int K2, int N,
+                           double* C, const GemmKernel& g = gemm_kernel()) {
+    if (!A || !B || !C || M<=0 || K<=0 || N<=0 || K!=K2) return;
+    const int T = pool.size();
+    const int nt = std::min(g.nc, (512 + g.nr - 1) / g.nr * g.nr);
+    const int tiles_n = (N + nt - 1) / nt;
+    // at least ~4 tiles per thread for balance, but never thinner than one MR panel
+    int mt = g.mc;
+    const int want = 4 * T;
+    if (((M + mt - 1) / mt) * tiles_n < want) {
+        const int rows = std::max(1, M * tiles_n / want);
+        mt = std::max(g.mr, (rows + g.mr - 1) / g.mr * g.mr);
+    }
+    const int tiles_m = (M + mt - 1) / mt;
+    const size_t tiles = (size_t)tiles_m * tiles_n;
+
+    pool.run([&](int t) {
+        size_t lo, hi;
+        split_range(tiles, T, t, 1, lo, hi);
+        if (hi <= lo) return;
+        GemmWorkspace& ws = thread_gemm_workspace(g);
+        for (size_t id=lo; id<hi; ++id) {
+            const int i0 = (int)(id / tiles_n) * mt, j0 = (int)(id % tiles_n) * nt;
+            const int m = std::min(mt, M - i0), n = std::min(nt, N - j0);
+            gemm_packed_block(A + (size_t)i0*K, (size_t)K, B + j0, (size_t)N,
+                              C + (size_t)i0*N + j0, (size_t)N, m, K, n, g, ws);
+        }
+    });
+}
+
+static inline double gflops_mm(int M, int K, int N, double ms) {
+    return ms > 0.0 ? 2.0 * M * K * N / (ms * 1e6) : 0.0;
+}
+
+// ================= Roofline =================
+// Machine ceilings from two micro-benchmarks (single core, like most kernels here):
+//   peak: independent FMA chains in the widest vector ISA, enough of them to hide latency
+//   bandwidth: STREAM triad a = b + s*c over arrays well beyond L3 (3 x 8 bytes/element)
+// A kernel's arithmetic intensity (flops / compulsory DRAM bytes) then gives its roof:
+// min(peak, AI * bandwidth). Left of the ridge point (peak / bandwidth) it is memory-bound.
+struct Roofline {
+    const char* isa;
+    double peak_gflops, stream_gbs;
+    double ridge() const { return peak_gflops / stream_gbs; }
+    double roof(double ai) const { return std::min(peak_gflops, ai * stream_gbs); }
+};
+
+template<typename Fn>
+static double best_seconds(Fn&& f, int runs) {
+    double best = 1e30;
+    for (int i=0; i<runs; ++i) {
+        auto t0 = clock_t_::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(clock_t_::now() - t0).count());
+    }
+    return best;
+}
+
+static volatile double g_roofline_sink = 0.0;
+
+// Each FMA chain: acc = acc*a + b, with a just below 1 so values stay bounded
+static double fma_peak_scalar(long iters) {
+    double acc[8];
+    for (int k=0; k<8; ++k) acc[k] = 1.0 + k*1e-3;
+    const double a = 0.9999999, b = 1e-7;
+    for (long it=0; it<iters; ++it)
+        for (int k=0; k<8; ++k) acc[k] = std::fma(acc[k], a, b);
+    double sum = 0.0;
+    for (int k=0; k<8; ++k) sum += acc[k];  // every chain must reach the sink or it is dead code
+    g_roofline_sink = sum;
+    return 2.0 * 8 * (double)iters;
+}
+
+#ifdef LA_X86_DISPATCH
+__attribute__((target("avx2,fma")))
+static double fma_peak_avx2(long iters) {
+    __m256d acc[10];  // 10 chains + 2 constants fit the 16 ymm registers
+    #pragma GCC unroll 10
+    for (int k=0; k<10; ++k) acc[k] = _mm256_set1_pd(1.0 + k*1e-3);
+    const __m256d a = _mm256_set1_pd(0.9999999), b = _mm256_set1_pd(1e-7);
+    for (long it=0; it<iters; ++it) {
+        #pragma GCC unroll 10
+        for (int k=0; k<10; ++k) acc[k] = _mm256_fmadd_pd(acc[k], a, b);
+    }
+    for (int k=1; k<10; ++k) acc[0] = _mm256_add_pd(acc[0], acc[k]);
+    alignas(32) double out[4];
+    _mm256_store_pd(out, acc[0]);
+    g_roofline_sink = out[0] + out[1] + out[2] + out[3];
+    return 2.0 * 10 * 4 * (double)iters;
+}
+
+__attribute__((target("avx512f")))
+static double fma_peak_avx512(long iters) {
+    __m512d acc[24];  // 24 chains: 4-cycle latency x 2 FMA ports x 3 for slack
+    #pragma GCC unroll 24
+    for (int k=0; k<24; ++k) acc[k] = _mm512_set1_pd(1.0 + k*1e-3);
+    const __m512d a = _mm512_set1_pd(0.9999999), b = _mm512_set1_pd(1e-7);
+    for (long it=0; it<iters; ++it) {
+        #pragma GCC unroll 24
+        for (int k=0; k<24; ++k) acc[k] = _mm512_fmadd_pd(acc[k], a, b);
+    }
+    for (int k=1; k<24; ++k) acc[0] = _mm512_add_pd(acc[0], acc[k]);
+    alignas(64) double out[8];
+    _mm512_store_pd(out, acc[0]);
+    g_roofline_sink = out[0] + out[1] + out[2] + out[3] + out[4] + out[5] + out[6] + out[7];
+    return 2.0 * 24 * 8 * (double)iters;
+}
+#endif
+
+static Roofline measure_roofline() {
+    Roofline r{"scalar", 0.0, 0.0};
+    double (*peak)(long) = fma_peak_scalar;
+#ifdef LA_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))                                   { peak = fma_peak_avx512; r.isa = "avx512"; }
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { peak = fma_peak_avx2;   r.isa = "avx2"; }
+#endif
+    const long iters = 20'000'000;
+    double flops = 0.0;
+    const double secs = best_seconds([&]{ flops = peak(iters); }, 5);
+    r.peak_gflops = flops / secs / 1e9;
+
+    const size_t n = (size_t)1 << 23;  // 3 x 64 MB
+    double* a = aligned_alloc_double(n);
+    double* b = aligned_alloc_double(n);
+    double* c = aligned_alloc_double(n);
+    for (size_t i=0; i<n; ++i) { a[i] = 0.0; b[i] = 1.0; c[i] = 2.0; }
+    const double s = 3.0;
+    const double t = best_seconds([&]{ for (size_t i=0; i<n; ++i) a[i] = b[i] + s*c[i]; }, 5);
+    g_roofline_sink = a[n/2];
+    r.stream_gbs = 3.0 * sizeof(double) * (double)n / t / 1e9;
+    aligned_free(a); aligned_free(b); aligned_free(c);
+    return r;
+}
+
+// One measured kernel: flops and the compulsory bytes (each input read once, each
+// output written once), not the traffic the kernel actually generates
+struct PerfRow {
+    string kernel;
+    int n;
+    double flops, bytes, ms;
+    double gflops() const { return flops / (ms * 1e6); }
+    double gbs()    const { return bytes / (ms * 1e6); }
+    double ai()     const { return bytes > 0.0 ? flops / bytes : 0.0; }
+};
+static vector<PerfRow> g_perf;
+
+static void record_perf(const string& kernel, int n, double flops, double bytes, const Stats& s) {
+    g_perf.push_back({kernel, n, flops, bytes, s.mean_ms});
+}
+static inline double mv_flops(int n) { return 2.0 * n * n; }
+static inline double mv_bytes(int n) { return 8.0 * ((double)n*n + 2.0*n); }
+static inline double mm_flops(int n) { return 2.0 * n * n * (double)n; }
+static inline double mm_bytes(int n) { return 8.0 * 3.0 * n * (double)n; }
+
+static void print_roofline(const Roofline& r) {
+    printf("\n=== Roofline (peak %.1f GFLOP/s [%s FMA], stream triad %.1f GB/s, ridge %.2f flop/byte) ===\n",
+           r.peak_gflops, r.isa, r.stream_gbs, r.ridge());
+    printf("%-16s %6s | %9s  %8s  %8s | %9s  %7s  %s\n",
+           "kernel", "N", "GFLOP/s", "GB/s", "AI", "roof", "% roof", "bound");
+    printf("------------------------+------------------------------+---------------------------\n");
+    for (const PerfRow& p : g_perf) {
+        const double ai = p.ai();
+        const bool mem = ai < r.ridge();
+        // memory-bound rows are judged on bandwidth, compute-bound rows on flops
+        const double pct = mem ? 100.0 * p.gbs() / r.stream_gbs : 100.0 * p.gflops() / r.peak_gflops;
+        char roof[16] = "-";  // data movement only (transpose): no flop roof
+        if (p.flops > 0.0) snprintf(roof, sizeof roof, "%9.2f", r.roof(ai));
+        printf("%-16s %6d | %9.2f  %8.2f  %8.2f | %9s  %6.1f%%  %s\n",
+               p.kernel.c_str(), p.n, p.gflops(), p.gbs(), ai, roof, pct, mem ? "memory" : "compute");
+    }
+    puts("% roof is GB/s vs stream for memory-bound rows, GFLOP/s vs peak for compute-bound ones;\n"
+         "over 100% means the working set stayed in cache rather than coming from DRAM.");
+}
+
 static void simple_tests() {
     // MM: naive vs B^T
     {
@@ -213,6 +1238,142 @@ static void simple_tests() {
             cerr << "MM small test FAILED\n"; exit(1);
         }
     }
+    // MM: packed GEMM vs naive, odd sizes (edge tiles, K split across KC blocks), every kernel
+    {
+        const int M=37,K=300,N=53;
+        vector<double> A((size_t)M*K), B((size_t)K*N), C1((size_t)M*N), C2((size_t)M*N);
+        fill_random(A.data(), A.size(), 7);
+        fill_random(B.data(), B.size(), 8);
+        multiply_mm_naive(A.data(),M,K, B.data(),K,N, C1.data());
+        vector<const GemmKernel*> kernels = { &kGemmGeneric, &gemm_kernel() };
+        for (const GemmKernel* g : kernels) {
+            multiply_mm_packed(A.data(),M,K, B.data(),K,N, C2.data(), *g);
+            if (!allclose(C1.data(), C2.data(), C1.size(), 1e-9)) {
+                cerr << "MM packed test FAILED (" << g->name << ")\n"; exit(1);
+            }
+        }
+        // float32 kernels against the double result
+        vector<float> Af(A.begin(), A.end()), Bf(B.begin(), B.end()), Cf((size_t)M*N);
+        vector<const GemmKernelF32*> kernels_f32 = { &kGemmGenericF32, &gemm_kernel_f32() };
+        for (const GemmKernelF32* g : kernels_f32) {
+            multiply_mm_packed(Af.data(),M,K, Bf.data(),K,N, Cf.data(), *g);
+            if (max_rel_err(Cf.data(), C1.data(), C1.size()) > 1e-5) {
+                cerr << "MM float32 test FAILED (" << g->name << ")\n"; exit(1);
+            }
+        }
+        // float compute, double accumulate, against a double GEMM on the float-rounded
+        // inputs: float error only builds up over one flush, so it must beat plain f32
+        vector<double> Ar(Af.begin(), Af.end()), Br(Bf.begin(), Bf.end()), Cr((size_t)M*N);
+        multiply_mm_naive(Ar.data(),M,K, Br.data(),K,N, Cr.data());
+        for (const GemmKernelF32* g : kernels_f32) {
+            multiply_mm_packed(Af.data(),M,K, Bf.data(),K,N, Cf.data(), *g);
+            multiply_mm_packed(Af.data(),M,K, Bf.data(),K,N, C2.data(), *g);
+            const double e32 = max_rel_err(Cf.data(), Cr.data(), Cr.size());
+            const double emix = max_rel_err(C2.data(), Cr.data(), Cr.size());
+            if (emix > 1e-5 || emix >= e32) {
+                cerr << "MM f32/f64 test FAILED (" << g->name << ")\n"; exit(1);
+            }
+        }
+        vector<float> xf(Af.begin(), Af.begin() + K), yf(M);
+        vector<double> x(xf.begin(), xf.end()), y1(M), y2(M);
+        multiply_mv_row_major(A.data(),M,K, x.data(), y1.data());
+        multiply_mv_rm(Af.data(),M,K, xf.data(), yf.data());
+        multiply_mv_rm(Af.data(),M,K, xf.data(), y2.data());
+        if (max_rel_err(yf.data(), y1.data(), (size_t)M) > 1e-5 ||
+            max_rel_err(y2.data(), y1.data(), (size_t)M) > 1e-5) {
+            cerr << "MV float32 test FAILED\n"; exit(1);
+        }
+    }
+    // Transpose: tiled vs naive (odd shape), in-place vs out-of-place (odd and tile-multiple n)
+    {
+        const int R=37, C=53;
+        vector<double> B((size_t)R*C), T1((size_t)R*C), T2((size_t)R*C);
+        fill_random(B.data(), B.size(), 27);
+        transpose_rowmajor(B.data(), R, C, T1.data());
+        transpose_tiled(B.data(), R, C, T2.data());
+        bool ok = T1 == T2;
+        for (int n : {1, 6, 37, 64}) {
+            vector<double> S((size_t)n*n), Tn((size_t)n*n);
+            fill_random(S.data(), S.size(), 28);
+            transpose_rowmajor(S.data(), n, n, Tn.data());
+            transpose_inplace_square(S.data(), n);
+            ok = ok && S == Tn;
+        }
+        if (!ok) { cerr << "Transpose test FAILED\n"; exit(1); }
+    }
+    // Matrix / MatrixView: every layout combination, padded ld and a strided sub-block
+    {
+        const int M=13,K=9,N=11;
+        vector<double> A((size_t)M*K), B((size_t)K*N), Cref((size_t)M*N), x(K), yref(M);
+        fill_random(A.data(), A.size(), 21);
+        fill_random(B.data(), B.size(), 22);
+        fill_random(x.data(), x.size(), 23);
+        multiply_mm_naive(A.data(),M,K, B.data(),K,N, Cref.data());
+        multiply_mv_row_major(A.data(),M,K, x.data(), yref.data());
+
+        Matrix<double, RowMajor> Ar(M,K), Br(K,N), Cr(M,N);
+        Matrix<double, ColMajor> Ac(M,K), Bc(K,N), Cc(M,N);
+        for (int i=0;i<M;++i) for (int k=0;k<K;++k) Ar(i,k) = Ac(i,k) = A[(size_t)i*K + k];
+        for (int k=0;k<K;++k) for (int j=0;j<N;++j) Br(k,j) = Bc(k,j) = B[(size_t)k*N + j];
+        auto same = [&](auto& C) {
+            for (int i=0;i<M;++i) for (int j=0;j<N;++j)
+                if (!nearly_equal(C(i,j), Cref[(size_t)i*N + j])) return false;
+            return true;
+        };
+        bool ok = Ar.ld() % 8 == 0 && Ac.ld() % 8 == 0;
+        multiply_mm(Ar, Br, Cr); ok = ok && same(Cr);
+        multiply_mm(Ar, Bc, Cr); ok = ok && same(Cr);
+        multiply_mm(Ac, Br, Cc); ok = ok && same(Cc);
+        multiply_mm(Ac, Bc, Cr); ok = ok && same(Cr);
+        vector<double> y1(M), y2(M);
+        multiply_mv(Ar, x.data(), y1.data());
+        multiply_mv(Ac, x.data(), y2.data());
+        ok = ok && allclose(y1.data(), yref.data(), (size_t)M) && allclose(y2.data(), yref.data(), (size_t)M);
+        // C[2..7, 3..8] = A[2..7, :] * B[:, 3..8] through strided views
+        Matrix<double, RowMajor> Cs(M,N);
+        multiply_mm(Ar.view().block(2,0,6,K), Br.view().block(0,3,K,6), Cs.view().block(2,3,6,6));
+        for (int i=2;i<8;++i) for (int j=3;j<9;++j)
+            ok = ok && nearly_equal(Cs(i,j), Cref[(size_t)i*N + j]);
+        ok = ok && Cs(0,0) == 0.0 && Cs(8,9) == 0.0;
+        if (!ok) { cerr << "Matrix/MatrixView test FAILED\n"; exit(1); }
+    }
+    // Small fixed-size kernels: non-square batch vs naive per item
+    {
+        const int M=3,K=5,N=4; const size_t cnt=7;
+        vector<double> A(cnt*M*K), B(cnt*K*N), C1(cnt*M*N), C2(cnt*M*N);
+        vector<double> x(cnt*K), y1(cnt*M), y2(cnt*M);
+        fill_random(A.data(), A.size(), 15);
+        fill_random(B.data(), B.size(), 16);
+        fill_random(x.data(), x.size(), 17);
+        for (size_t b=0; b<cnt; ++b) {
+            multiply_mm_naive(A.data()+b*M*K,M,K, B.data()+b*K*N,K,N, C1.data()+b*M*N);
+            multiply_mv_row_major(A.data()+b*M*K,M,K, x.data()+b*K, y1.data()+b*M);
+        }
+        batched_mm_small<M,K,N>(A.data(), B.data(), C2.data(), cnt);
+        batched_mv_small<M,K>(A.data(), x.data(), y2.data(), cnt);
+        if (!allclose(C1.data(), C2.data(), C1.size(), 1e-12) ||
+            !allclose(y1.data(), y2.data(), y1.size(), 1e-12)) {
+            cerr << "Small batched MM/MV test FAILED\n"; exit(1);
+        }
+    }
+    // Threaded GEMM/GEMV vs serial, odd sizes, more threads than row blocks
+    {
+        const int M=45,K=70,N=613;
+        vector<double> A((size_t)M*K), B((size_t)K*N), C1((size_t)M*N), C2((size_t)M*N);
+        vector<double> x(K), y1(M), y2(M);
+        fill_random(A.data(), A.size(), 9);
+        fill_random(B.data(), B.size(), 10);
+        fill_random(x.data(), x.size(), 11);
+        ThreadPool pool(7);
+        multiply_mm_packed(A.data(),M,K, B.data(),K,N, C1.data());
+        multiply_mm_packed_mt(pool, A.data(),M,K, B.data(),K,N, C2.data());
+        multiply_mv_row_major(A.data(),M,K, x.data(), y1.data());
+        multiply_mv_row_major_mt(pool, A.data(),M,K, x.data(), y2.data());
+        if (!allclose(C1.data(), C2.data(), C1.size(), 1e-12) ||
+            !allclose(y1.data(), y2.data(), y1.size(), 1e-12)) {
+            cerr << "Threaded MM/MV test FAILED\n"; exit(1);
+        }
+    }
     // MV: row-major vs column-major
     {
         const int R=3,C=4;
@@ -235,6 +1396,11 @@ int main(int argc, char** argv) {
     cin.tie(nullptr);
 
     simple_tests();
+    cout.flush();  // cout is unsynced from printf; keep the test line ahead of the tables
+
+    const Roofline roofline = measure_roofline();
+    printf("Machine: peak %.1f GFLOP/s (%s FMA, 1 core), stream triad %.1f GB/s\n",
+           roofline.peak_gflops, roofline.isa, roofline.stream_gbs);
 
     vector<int> sizes = {256, 512, 1024, 1536, 2048};
     if (argc > 1) {
@@ -263,6 +1429,8 @@ int main(int argc, char** argv) {
         auto s2 = time_it([&]{ multiply_mv_col_major(A_col, n,n, x, y2); }, 5);
 
         if (!allclose(y1,y2,(size_t)n,1e-9)) cerr << "MV mismatch at n="<<n<<"\n";
+        record_perf("mv row-major", n, mv_flops(n), mv_bytes(n), s1);
+        record_perf("mv col-major", n, mv_flops(n), mv_bytes(n), s2);
         printf("%6d  | %10.3f \xC2\xB1 %-7.3f  %10.3f \xC2\xB1 %-7.3f\n",
                n, s1.mean_ms, s1.std_ms, s2.mean_ms, s2.std_ms);
 
@@ -270,10 +1438,12 @@ int main(int argc, char** argv) {
         aligned_free(x); aligned_free(y1); aligned_free(y2);
     }
 
-    // MM: naive vs B^T vs blocked
-    printf("\n=== Matrix-Matrix (naive vs B^T vs blocked) ===\n");
-    printf("%6s  | %12s  %12s  %12s\n", "N", "naive (ms)", "B^T (ms)", "blocked (ms)");
-    printf("--------+-----------------------------------------------\n");
+    // MM: naive vs B^T vs blocked vs packed
+    printf("\n=== Matrix-Matrix (naive vs B^T vs blocked vs packed [%s]) ===\n", gemm_kernel().name);
+    printf("%6s  | %12s  %12s  %12s  %12s\n", "N", "naive (ms)", "B^T (ms)", "blocked (ms)", "packed (ms)");
+    printf("--------+--------------------------------------------------------------\n");
+    struct MMRow { int n; double naive, bt, blk, packed; };
+    vector<MMRow> mm_rows;
     for (int n : sizes) {
         int M=n,K=n,N=n;
         double* A  = aligned_alloc_double((size_t)M*K);
@@ -281,6 +1451,7 @@ int main(int argc, char** argv) {
         double* C1 = aligned_alloc_double((size_t)M*N);
         double* C2 = aligned_alloc_double((size_t)M*N);
         double* C3 = aligned_alloc_double((size_t)M*N);
+        double* C4 = aligned_alloc_double((size_t)M*N);
         vector<double> BT((size_t)N*K);
 
         fill_random(A, (size_t)M*K, 5);
@@ -296,19 +1467,256 @@ int main(int argc, char** argv) {
 
         auto t_blk = time_it([&]{ multiply_mm_blocked(A,M,K,B,K,N,C3, 128,128,256); }, 3);
 
-        if (!allclose(C1,C2,(size_t)M*N,1e-8) || !allclose(C1,C3,(size_t)M*N,1e-8)) {
+        auto t_pk = time_it([&]{ multiply_mm_packed(A,M,K,B,K,N,C4); }, 3);
+
+        if (!allclose(C1,C2,(size_t)M*N,1e-8) || !allclose(C1,C3,(size_t)M*N,1e-8)
+            || !allclose(C1,C4,(size_t)M*N,1e-8)) {
             cerr << "MM mismatch at n="<<n<<"\n";
         }
 
-        printf("%6d  | %10.1f \xC2\xB1 %-5.1f  %10.1f \xC2\xB1 %-5.1f  %10.1f \xC2\xB1 %-5.1f\n",
+        printf("%6d  | %10.1f \xC2\xB1 %-5.1f  %10.1f \xC2\xB1 %-5.1f  %10.1f \xC2\xB1 %-5.1f  %10.1f \xC2\xB1 %-5.1f\n",
                n, t_naive.mean_ms, t_naive.std_ms,
                t_bt.mean_ms, t_bt.std_ms,
-               t_blk.mean_ms, t_blk.std_ms);
+               t_blk.mean_ms, t_blk.std_ms,
+               t_pk.mean_ms, t_pk.std_ms);
+        mm_rows.push_back({n, t_naive.mean_ms, t_bt.mean_ms, t_blk.mean_ms, t_pk.mean_ms});
+        record_perf("mm naive",   n, mm_flops(n), mm_bytes(n), t_naive);
+        record_perf("mm B^T",     n, mm_flops(n), mm_bytes(n), t_bt);
+        record_perf("mm blocked", n, mm_flops(n), mm_bytes(n), t_blk);
+        record_perf("mm packed",  n, mm_flops(n), mm_bytes(n), t_pk);
 
         aligned_free(A); aligned_free(B);
-        aligned_free(C1); aligned_free(C2); aligned_free(C3);
+        aligned_free(C1); aligned_free(C2); aligned_free(C3); aligned_free(C4);
+    }
+
+    printf("\n=== Matrix-Matrix GFLOP/s (2*N^3 / mean time) ===\n");
+    printf("%6s  | %10s  %10s  %10s  %10s\n", "N", "naive", "B^T", "blocked", "packed");
+    printf("--------+----------------------------------------------\n");
+    for (const MMRow& r : mm_rows) {
+        printf("%6d  | %10.2f  %10.2f  %10.2f  %10.2f\n", r.n,
+               gflops_mm(r.n,r.n,r.n,r.naive), gflops_mm(r.n,r.n,r.n,r.bt),
+               gflops_mm(r.n,r.n,r.n,r.blk), gflops_mm(r.n,r.n,r.n,r.packed));
+    }
+
+    // Mixed precision: same inputs rounded to float; error is against the double kernels
+    printf("\n=== Mixed precision (f64 vs f32 vs f32 compute + f64 accumulate; GEMM [%s]/[%s]) ===\n",
+           gemm_kernel().name, gemm_kernel_f32().name);
+    printf("%6s  | %9s  %9s  %9s  %6s  %6s  %8s  %8s | %9s  %9s  %9s  %6s  %6s  %8s  %8s\n", "N",
+           "GEMV f64", "f32", "f32+f64", "x f32", "x mix", "err f32", "err mix",
+           "GEMM f64", "f32", "f32+f64", "x f32", "x mix", "err f32", "err mix");
+    printf("--------+-------------------------------------------------------------------------------"
+           "+-------------------------------------------------------------------------------\n");
+    for (int n : sizes) {
+        const size_t nn = (size_t)n*n;
+        double* A  = aligned_alloc_double(nn);
+        double* B  = aligned_alloc_double(nn);
+        double* C  = aligned_alloc_double(nn);
+        double* Cm = aligned_alloc_double(nn);
+        double* x  = aligned_alloc_double(n);
+        double* y  = aligned_alloc_double(n);
+        double* ym = aligned_alloc_double(n);
+        float* Af = aligned_alloc_array<float>(nn);
+        float* Bf = aligned_alloc_array<float>(nn);
+        float* Cf = aligned_alloc_array<float>(nn);
+        float* xf = aligned_alloc_array<float>(n);
+        float* yf = aligned_alloc_array<float>(n);
+        fill_random(A, nn, 30);
+        fill_random(B, nn, 31);
+        fill_random(x, n, 32);
+        std::copy(A, A + nn, Af);
+        std::copy(B, B + nn, Bf);
+        std::copy(x, x + n, xf);
+        std::memset(Cf, 0, sizeof(float) * nn);
+        std::memset(Cm, 0, sizeof(double) * nn);
+
+        auto t_mv64 = time_it([&]{ multiply_mv_rm(A, n,n, x, y); }, 5);
+        auto t_mv32 = time_it([&]{ multiply_mv_rm(Af, n,n, xf, yf); }, 5);
+        auto t_mvmx = time_it([&]{ multiply_mv_rm(Af, n,n, xf, ym); }, 5);
+        auto t_mm64 = time_it([&]{ multiply_mm_packed(A,n,n, B,n,n, C); }, 3);
+        auto t_mm32 = time_it([&]{ multiply_mm_packed(Af,n,n, Bf,n,n, Cf); }, 3);
+        auto t_mmmx = time_it([&]{ multiply_mm_packed(Af,n,n, Bf,n,n, Cm); }, 3);
+        // not in the roofline table: its peak is the double FMA rate
+
+        printf("%6d  | %9.3f  %9.3f  %9.3f  %5.2fx  %5.2fx  %8.1e  %8.1e | %9.2f  %9.2f  %9.2f  %5.2fx  %5.2fx  %8.1e  %8.1e\n",
+               n, t_mv64.mean_ms, t_mv32.mean_ms, t_mvmx.mean_ms,
+               t_mv64.mean_ms / t_mv32.mean_ms, t_mv64.mean_ms / t_mvmx.mean_ms,
+               max_rel_err(yf, y, (size_t)n), max_rel_err(ym, y, (size_t)n),
+               t_mm64.mean_ms, t_mm32.mean_ms, t_mmmx.mean_ms,
+               t_mm64.mean_ms / t_mm32.mean_ms, t_mm64.mean_ms / t_mmmx.mean_ms,
+               max_rel_err(Cf, C, nn), max_rel_err(Cm, C, nn));
+
+        aligned_free(A); aligned_free(B); aligned_free(C); aligned_free(Cm);
+        aligned_free(x); aligned_free(y); aligned_free(ym);
+        aligned_free(Af); aligned_free(Bf); aligned_free(Cf); aligned_free(xf); aligned_free(yf);
+    }
+
+    // Transpose bandwidth: bytes read + written (2 * 8 * n^2) per call
+    printf("\n=== Transpose GB/s (naive vs tiled 32x32 / 4x4 %s vs in-place) ===\n",
+           transpose_use_avx2() ? "avx2" : "scalar");
+    printf("%6s  | %10s  %10s  %10s\n", "N", "naive", "tiled", "in-place");
+    printf("--------+------------------------------------\n");
+    for (int n : sizes) {
+        if (n < 256 || n > 4096) continue;
+        const size_t nn = (size_t)n*n;
+        double* S  = aligned_alloc_double(nn);
+        double* T1 = aligned_alloc_double(nn);
+        double* T2 = aligned_alloc_double(nn);
+        fill_random(S, nn, 29);
+        std::memset(T1, 0, sizeof(double) * nn); // fault pages in outside the timing
+        std::memset(T2, 0, sizeof(double) * nn);
+        auto t_nv = time_it([&]{ transpose_rowmajor(S, n, n, T1); }, 5);
+        auto t_tl = time_it([&]{ transpose_tiled(S, n, n, T2); }, 5);
+        bool ok = std::equal(T1, T1 + nn, T2);
+        // odd number of in-place runs leaves S transposed
+        auto t_ip = time_it([&]{ transpose_inplace_square(S, n); }, 5);
+        ok = ok && std::equal(S, S + nn, T1);
+        if (!ok) cerr << "Transpose mismatch at n="<<n<<"\n";
+        record_perf("transpose naive", n, 0.0, 16.0 * (double)nn, t_nv);
+        record_perf("transpose tiled", n, 0.0, 16.0 * (double)nn, t_tl);
+        record_perf("transpose in-pl", n, 0.0, 16.0 * (double)nn, t_ip);
+        const double gb = 2.0 * sizeof(double) * (double)nn / 1e9;
+        printf("%6d  | %10.2f  %10.2f  %10.2f\n", n,
+               gb / (t_nv.mean_ms * 1e-3), gb / (t_tl.mean_ms * 1e-3), gb / (t_ip.mean_ms * 1e-3));
+        aligned_free(S); aligned_free(T1); aligned_free(T2);
+    }
+
+    // Matrix type: ld = n (tight) vs padded ld, same kernels through MatrixView
+    printf("\n=== Leading dimension: tight (ld = n) vs padded Matrix ===\n");
+    printf("%6s  %6s | %16s  %16s | %16s  %16s\n", "N", "ld", "GEMM tight (ms)", "GEMM padded (ms)",
+           "MV col tight", "MV col padded");
+    printf("----------------+-------------------------------------+-------------------------------------\n");
+    for (int n : sizes) {
+        const size_t nn = (size_t)n*n;
+        double* At = aligned_alloc_double(nn);
+        double* Bt = aligned_alloc_double(nn);
+        double* Ct = aligned_alloc_double(nn);
+        double* Acm = aligned_alloc_double(nn);
+        fill_random(At, nn, 24);
+        fill_random(Bt, nn, 25);
+        fill_random(Acm, nn, 24);
+        Matrix<double, RowMajor> Ap(n,n), Bp(n,n), Cp(n,n);
+        Matrix<double, ColMajor> Acp(n,n);
+        for (int i=0;i<n;++i) for (int j=0;j<n;++j) {
+            Ap(i,j) = At[(size_t)i*n + j];
+            Bp(i,j) = Bt[(size_t)i*n + j];
+            Acp(i,j) = Acm[(size_t)j*n + i];
+        }
+        vector<double> x(n), y1(n), y2(n);
+        fill_random(x.data(), x.size(), 26);
+
+        MatrixView<const double> Atv(At, n, n, n), Btv(Bt, n, n, n);
+        MatrixView<double> Ctv(Ct, n, n, n);
+        MatrixView<const double, ColMajor> Acv(Acm, n, n, n);
+        auto t_mm_t = time_it([&]{ multiply_mm(Atv, Btv, Ctv); }, 3);
+        auto t_mm_p = time_it([&]{ multiply_mm(Ap, Bp, Cp); }, 3);
+        auto t_mv_t = time_it([&]{ multiply_mv(Acv, x.data(), y1.data()); }, 5);
+        auto t_mv_p = time_it([&]{ multiply_mv(Acp, x.data(), y2.data()); }, 5);
+
+        bool ok = allclose(y1.data(), y2.data(), (size_t)n, 1e-12);
+        for (int i=0; ok && i<n; ++i)
+            for (int j=0; j<n; ++j) if (!nearly_equal(Ctv(i,j), Cp(i,j), 1e-12)) { ok = false; break; }
+        if (!ok) cerr << "Padded/tight mismatch at n="<<n<<"\n";
+
+        printf("%6d  %6zu | %10.2f \xC2\xB1 %-4.2f  %10.2f \xC2\xB1 %-4.2f | %10.3f \xC2\xB1 %-4.3f  %10.3f \xC2\xB1 %-4.3f\n",
+               n, Ap.ld(), t_mm_t.mean_ms, t_mm_t.std_ms, t_mm_p.mean_ms, t_mm_p.std_ms,
+               t_mv_t.mean_ms, t_mv_t.std_ms, t_mv_p.mean_ms, t_mv_p.std_ms);
+        aligned_free(At); aligned_free(Bt); aligned_free(Ct); aligned_free(Acm);
+    }
+
+    // Batched small matrices: compile-time kernels vs the generic kernels in a loop
+    {
+        const size_t batch = 8192;
+        printf("\n=== Batched small matrices (%zu per batch; ns per item) ===\n", batch);
+        printf("%6s  | %12s  %12s  %12s  %8s | %12s  %12s  %8s\n", "n",
+               "MM blocked", "MM naive", "MM template", "speedup", "MV row-major", "MV template", "speedup");
+        printf("--------+------------------------------------------------------+--------------------------------------\n");
+        for (int n : {4, 6, 8, 12, 16}) {
+            const size_t nn = (size_t)n*n;
+            vector<double> A(batch*nn), B(batch*nn), C1(batch*nn), C2(batch*nn), C3(batch*nn);
+            vector<double> x(batch*n), y1(batch*n), y2(batch*n);
+            fill_random(A.data(), A.size(), 18);
+            fill_random(B.data(), B.size(), 19);
+            fill_random(x.data(), x.size(), 20);
+
+            auto t_blk = time_it([&]{
+                for (size_t b=0; b<batch; ++b)
+                    multiply_mm_blocked(A.data()+b*nn, n,n, B.data()+b*nn, n,n, C1.data()+b*nn);
+            }, 5);
+            auto t_nv = time_it([&]{
+                for (size_t b=0; b<batch; ++b)
+                    multiply_mm_naive(A.data()+b*nn, n,n, B.data()+b*nn, n,n, C2.data()+b*nn);
+            }, 5);
+            auto t_tpl = time_it([&]{ batched_mm_square(n, A.data(), B.data(), C3.data(), batch); }, 5);
+            auto t_mv = time_it([&]{
+                for (size_t b=0; b<batch; ++b)
+                    multiply_mv_row_major(A.data()+b*nn, n,n, x.data()+b*n, y1.data()+b*n);
+            }, 5);
+            auto t_mvt = time_it([&]{ batched_mv_square(n, A.data(), x.data(), y2.data(), batch); }, 5);
+
+            if (!allclose(C1.data(), C3.data(), C1.size(), 1e-12) ||
+                !allclose(C2.data(), C3.data(), C2.size(), 1e-12) ||
+                !allclose(y1.data(), y2.data(), y1.size(), 1e-12))
+                cerr << "Batched small mismatch at n="<<n<<"\n";
+
+            const double to_ns = 1e6 / (double)batch;
+            printf("%6d  | %12.1f  %12.1f  %12.1f  %7.1fx | %12.1f  %12.1f  %7.1fx\n", n,
+                   t_blk.mean_ms*to_ns, t_nv.mean_ms*to_ns, t_tpl.mean_ms*to_ns,
+                   t_blk.mean_ms / t_tpl.mean_ms,
+                   t_mv.mean_ms*to_ns, t_mvt.mean_ms*to_ns, t_mv.mean_ms / t_mvt.mean_ms);
+        }
     }
 
+    // Strong scaling: fixed problem, 1..max threads (LA_THREADS overrides the core count)
+    int max_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    if (const char* env = std::getenv("LA_THREADS")) max_threads = std::max(1, atoi(env));
+    vector<int> thread_counts;
+    for (int t=1; t<max_threads; t*=2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+    vector<unique_ptr<ThreadPool>> pools;
+    for (int t : thread_counts) pools.emplace_back(new ThreadPool(t));
+
+    printf("\n=== Strong scaling (packed GEMM [%s], row-major GEMV; 1..%d threads) ===\n",
+           gemm_kernel().name, max_threads);
+    printf("%6s  %7s | %10s  %8s  %7s | %10s  %7s\n",
+           "N", "threads", "GEMM (ms)", "GFLOP/s", "speedup", "GEMV (ms)", "speedup");
+    printf("-----------------+-------------------------------+--------------------\n");
+    for (int n : sizes) {
+        if (n < 256 || n > 4096) continue;
+        const size_t nn = (size_t)n*n;
+        double* A = aligned_alloc_double(nn);
+        double* B = aligned_alloc_double(nn);
+        double* C = aligned_alloc_double(nn);
+        double* Cref = aligned_alloc_double(nn);
+        double* x = aligned_alloc_double(n);
+        double* y = aligned_alloc_double(n);
+        double* yref = aligned_alloc_double(n);
+        // placement follows the largest pool's row split
+        ThreadPool& widest = *pools.back();
+        first_touch(widest, A, nn); first_touch(widest, C, nn); first_touch(widest, Cref, nn);
+        fill_random(A, nn, 12);
+        fill_random(B, nn, 13);
+        fill_random(x, n, 14);
+        multiply_mm_packed(A,n,n, B,n,n, Cref);
+        multiply_mv_row_major(A,n,n, x, yref);
+
+        double mm1 = 0.0, mv1 = 0.0;
+        for (auto& pool : pools) {
+            auto t_mm = time_it([&]{ multiply_mm_packed_mt(*pool, A,n,n, B,n,n, C); }, 3);
+            auto t_mv = time_it([&]{ multiply_mv_row_major_mt(*pool, A,n,n, x, y); }, 5);
+            if (!allclose(C, Cref, nn, 1e-12) || !allclose(y, yref, (size_t)n, 1e-12))
+                cerr << "Threaded mismatch at n="<<n<<" threads="<<pool->size()<<"\n";
+            if (pool->size() == 1) { mm1 = t_mm.mean_ms; mv1 = t_mv.mean_ms; }
+            printf("%6d  %7d | %10.2f  %8.2f  %6.2fx | %10.3f  %6.2fx\n",
+                   n, pool->size(), t_mm.mean_ms, gflops_mm(n,n,n,t_mm.mean_ms),
+                   mm1 / t_mm.mean_ms, t_mv.mean_ms, mv1 / t_mv.mean_ms);
+        }
+
+        aligned_free(A); aligned_free(B); aligned_free(C); aligned_free(Cref);
+        aligned_free(x); aligned_free(y); aligned_free(yref);
+    }
+
+    print_roofline(roofline);
+
     puts("\nDone.");
     return 0;
 }
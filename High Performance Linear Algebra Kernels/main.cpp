@@ -166,14 +166,19 @@ void multiply_mm_naive(const double* matrixA, int rowsA, int colsA, const double
     assert(matrixA != nullptr);
     assert(matrixB != nullptr);
     assert(result != nullptr);
+    for (int i = 0; i < rowsA * colsB; i++)
+    {
+        result[i] = 0.0;
+    }
+    // result(i,j) += A(i,k) * B(k,j); B is rowsB x colsB row-major
     for (int i = 0; i < rowsA; i++)
     {
-        for (int j = 0; j < colsA; j++)
+        for (int k = 0; k < colsA; k++)
         {
-            double value_A = matrixA[i * colsA + j];
-            for (int k = 0; k < colsB; k++)
+            double value_A = matrixA[i * colsA + k];
+            for (int j = 0; j < colsB; j++)
             {
-                result[i * colsA + j] += value_A * matrixB[k * colsB + j];
+                result[i * colsB + j] += value_A * matrixB[k * colsB + j];
             }
         }
     }
@@ -1,19 +1,30 @@
 // hft_assignment.cpp (atomic-sink version; C++20)
-// Build (macOS): clang++ -std=c++20 -O3 -march=native -flto -DNDEBUG hft_assignment.cpp -o hft_bench
-// Build (Windows): cl /O2 /std:c++20 /DNDEBUG hft_assignment.cpp
+// Build (macOS): clang++ -std=c++20 -O3 -march=native -flto -DNDEBUG -I"../Session 4-HFT Tick Processing-CRTP vs Virtual Dispatch/include" hft_assignment.cpp -o hft_bench
+// Build (Windows): cl /O2 /std:c++20 /DNDEBUG /I"..\Session 4-HFT Tick Processing-CRTP vs Virtual Dispatch\include" hft_assignment.cpp
+// Linux needs -pthread for the parallel mode.
+// Usage: ./hft_bench [orders] [repeats] [out_csv] [max_threads]   (max_threads>0 enables parallel mode)
 
 #include <algorithm>
 #include <array>
 #include <atomic>   // <— added
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <random>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
 #include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "batch_dispatch.hpp"
 
 using Clock = std::chrono::high_resolution_clock;
 
@@ -42,18 +53,23 @@ struct WorkPolicy {
     static thread_local uint64_t s_branch_counter;
 
     static inline uint64_t do_work(Order& o) {
-        uint64_t h = o.id;
-        h ^= static_cast<uint64_t>(o.side) * 0x9e3779b97f4a7c15ULL;
-        h += static_cast<uint64_t>(o.qty) * 13u;
-        h ^= static_cast<uint64_t>(o.price) * 101u;
-        h ^= static_cast<uint64_t>(o.payload[0]) * 17u;
-        h += static_cast<uint64_t>(o.payload[1]) * 23u;
+        return do_work(o.id, o.side, o.qty, o.price, o.payload[0], o.payload[1]);
+    }
+
+    // field form, shared by the AoS Order and the SoA stream
+    static inline uint64_t do_work(uint64_t id, int side, int qty, int price, int p0, int p1) {
+        uint64_t h = id;
+        h ^= static_cast<uint64_t>(side) * 0x9e3779b97f4a7c15ULL;
+        h += static_cast<uint64_t>(qty) * 13u;
+        h ^= static_cast<uint64_t>(price) * 101u;
+        h ^= static_cast<uint64_t>(p0) * 17u;
+        h += static_cast<uint64_t>(p1) * 23u;
 
-        size_t idx = (static_cast<size_t>(o.id) + static_cast<size_t>(o.side) * 7) & (BOOK_SZ - 1);
-        s_book_qty[idx] = o.qty;    // write 1
-        s_book_px[idx]  = o.price;  // write 2
+        size_t idx = (static_cast<size_t>(id) + static_cast<size_t>(side) * 7) & (BOOK_SZ - 1);
+        s_book_qty[idx] = qty;    // write 1
+        s_book_px[idx]  = price;  // write 2
 
-        if ((o.price & 1) != 0) s_branch_counter += 1;
+        if ((price & 1) != 0) s_branch_counter += 1;
 
         return mix64(h);
     }
@@ -68,14 +84,14 @@ struct Processor {
     virtual ~Processor() = default;
     virtual uint64_t process(Order& o) = 0;
 };
-struct StrategyA_V : Processor {
+struct StrategyA_V final : Processor {
     uint64_t process(Order& o) override {
         o.qty   = (o.qty   * 3 + 1) & 1023;
         o.price = (o.price * 5 + 7) & 65535;
         return WorkPolicy::do_work(o);
     }
 };
-struct StrategyB_V : Processor {
+struct StrategyB_V final : Processor {
     uint64_t process(Order& o) override {
         o.qty   = (o.qty   * 7 + 2) & 2047;
         o.price = (o.price * 9 + 3) & 65535;
@@ -109,7 +125,23 @@ static const char* pattern_name(Pattern p) {
     }
     return "unknown";
 }
-static const char* impl_name(bool virtual_impl) { return virtual_impl ? "virtual" : "nonvirtual"; }
+enum Impl : int { kNonVirtual = 0, kVirtual = 1, kTypeSorted = 2,
+                  kFnTable = 3, kVariant = 4, kComputedGoto = 5,
+                  kSoaScalar = 6, kSoaSimd = 7, kNumImpls };
+
+static const char* impl_name(int impl) {
+    switch (impl) {
+        case kNonVirtual: return "nonvirtual";
+        case kVirtual:    return "virtual";
+        case kTypeSorted: return "typesorted";
+        case kFnTable:    return "fntable";
+        case kVariant:    return "variant";
+        case kComputedGoto: return "computedgoto";
+        case kSoaScalar:  return "soa_scalar";
+        case kSoaSimd:    return "soa_simd";
+    }
+    return "unknown";
+}
 
 static void make_orders(std::vector<Order>& orders, size_t N) {
     orders.resize(N);
@@ -193,6 +225,398 @@ static RunResult run_nonvirtual(const std::vector<Order>& base,
     return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
 }
 
+// ---- Type-sorted batch (devirtualized virtual impl) ----
+// TypeSortedBatch is shared with Session 4 (include/batch_dispatch.hpp, see the build lines)
+using OrderBatch = TypeSortedBatch<Processor, StrategyA_V, StrategyB_V>;
+
+// Bucketing is inside the timed region: it is part of the dispatch cost. The batch is
+// long-lived (like a real dispatcher) so its buffers are warm.
+// Same one relaxed fetch_add per order as virtual; the sum does not depend on order.
+static RunResult run_typesorted(const std::vector<Order>& base,
+                                const std::vector<uint8_t>& assign,
+                                OrderBatch& batch)
+{
+    std::vector<Order> orders = base;
+    StrategyA_V a; StrategyB_V b;
+    Processor* procs[2] = { &a, &b };
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+    batch.bucketize(orders.size(), [&](size_t i) { return procs[assign[i]]; });
+    batch.for_each([&](size_t i, auto& p) {
+        checksum.fetch_add(p.process(orders[i]), std::memory_order_relaxed); });
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(orders.size()) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+// ---- Function-pointer table ----
+// plugin-style: free functions indexed by strategy id, one indirect call per order
+// (like virtual) but no object/vptr load in front of it
+using StrategyFn = uint64_t (*)(Order&);
+static uint64_t strategy_a_fn(Order& o) { return StrategyA_NV{}.run(o); }
+static uint64_t strategy_b_fn(Order& o) { return StrategyB_NV{}.run(o); }
+static constexpr StrategyFn kStrategyTable[2] = { &strategy_a_fn, &strategy_b_fn };
+
+static RunResult run_fntable(const std::vector<Order>& base,
+                             const std::vector<uint8_t>& assign)
+{
+    std::vector<Order> orders = base;
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+    for (size_t i=0;i<orders.size();++i) {
+        checksum.fetch_add(kStrategyTable[assign[i]](orders[i]), std::memory_order_relaxed);
+    }
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(orders.size()) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+// ---- std::variant + std::visit ----
+// closed set of value types: visit compiles to a jump table (or compare chain) over the
+// index and each alternative's run() inlines
+using StrategyVariant = std::variant<StrategyA_NV, StrategyB_NV>;
+
+static RunResult run_variant(const std::vector<Order>& base,
+                             const std::vector<uint8_t>& assign)
+{
+    std::vector<Order> orders = base;
+    StrategyVariant strategies[2] = { StrategyA_NV{}, StrategyB_NV{} };
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+    for (size_t i=0;i<orders.size();++i) {
+        Order& o = orders[i];
+        checksum.fetch_add(std::visit([&](auto& s) { return s.run(o); }, strategies[assign[i]]),
+                           std::memory_order_relaxed);
+    }
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(orders.size()) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+// ---- Computed-goto interpreter ----
+// assign[] is treated as a bytecode stream; every handler ends in its own indirect jump
+// (threaded dispatch), so each jump site gets its own predictor history. GCC/Clang
+// labels-as-values extension; other compilers get the equivalent switch loop.
+static RunResult run_computed_goto(const std::vector<Order>& base,
+                                   const std::vector<uint8_t>& assign)
+{
+    std::vector<Order> orders = base;
+    StrategyA_NV a; StrategyB_NV b;
+    const size_t n = orders.size();
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+#if defined(__GNUC__)
+    static void* const handlers[2] = { &&op_a, &&op_b };
+    size_t i = 0;
+    if (n == 0) goto done;
+    goto *handlers[assign[0]];
+op_a:
+    checksum.fetch_add(a.run(orders[i]), std::memory_order_relaxed);
+    if (++i == n) goto done;
+    goto *handlers[assign[i]];
+op_b:
+    checksum.fetch_add(b.run(orders[i]), std::memory_order_relaxed);
+    if (++i == n) goto done;
+    goto *handlers[assign[i]];
+done:
+#else
+    for (size_t i=0;i<n;++i) {
+        switch (assign[i]) {
+            case 0:  checksum.fetch_add(a.run(orders[i]), std::memory_order_relaxed); break;
+            default: checksum.fetch_add(b.run(orders[i]), std::memory_order_relaxed); break;
+        }
+    }
+#endif
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(n) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+// ---- SoA order stream ----
+// one array per field: the hash/mix steps become 4-wide 64-bit lane arithmetic
+struct OrderSoA {
+    std::vector<uint64_t> id;
+    std::vector<int>      side, qty, price, payload0, payload1;
+    size_t size() const { return id.size(); }
+};
+
+static void to_soa(const std::vector<Order>& aos, OrderSoA& soa) {
+    const size_t n = aos.size();
+    soa.id.resize(n); soa.side.resize(n); soa.qty.resize(n);
+    soa.price.resize(n); soa.payload0.resize(n); soa.payload1.resize(n);
+    for (size_t i=0;i<n;++i) {
+        soa.id[i]       = aos[i].id;
+        soa.side[i]     = aos[i].side;
+        soa.qty[i]      = aos[i].qty;
+        soa.price[i]    = aos[i].price;
+        soa.payload0[i] = aos[i].payload[0];
+        soa.payload1[i] = aos[i].payload[1];
+    }
+}
+
+// StrategyA_NV / StrategyB_NV on SoA fields
+static inline uint64_t run_soa_one(OrderSoA& s, size_t i, uint8_t strategy) {
+    if (strategy == 0) {
+        s.qty[i]   = (s.qty[i]   * 3 + 1) & 1023;
+        s.price[i] = (s.price[i] * 5 + 7) & 65535;
+    } else {
+        s.qty[i]   = (s.qty[i]   * 7 + 2) & 2047;
+        s.price[i] = (s.price[i] * 9 + 3) & 65535;
+    }
+    return WorkPolicy::do_work(s.id[i], s.side[i], s.qty[i], s.price[i], s.payload0[i], s.payload1[i]);
+}
+
+// Layout change only: same branchy dispatch and per-order atomic as nonvirtual
+static RunResult run_soa_scalar(const std::vector<Order>& base,
+                                const std::vector<uint8_t>& assign)
+{
+    OrderSoA soa;
+    to_soa(base, soa);
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+    for (size_t i=0;i<soa.size();++i) {
+        checksum.fetch_add(run_soa_one(soa, i, assign[i]), std::memory_order_relaxed);
+    }
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(soa.size()) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+#if defined(__AVX2__)
+// 64-bit lane multiply (low 64 bits). AVX-512DQ/VL has it natively; on AVX2 it is built
+// from 32x32->64 products: a*b = lo(a)*lo(b) + ((hi(a)*lo(b) + lo(a)*hi(b)) << 32)
+static inline __m256i mul64_x4(__m256i a, __m256i b) {
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+    return _mm256_mullo_epi64(a, b);
+#else
+    const __m256i lo    = _mm256_mul_epu32(a, b);
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                           _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+#endif
+}
+
+static inline __m256i mix64_x4(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mul64_x4(x, _mm256_set1_epi64x(static_cast<long long>(0xff51afd7ed558ccdULL)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mul64_x4(x, _mm256_set1_epi64x(static_cast<long long>(0xc4ceb9fe1a85ec53ULL)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    return x;
+}
+
+// static_cast<uint64_t>(int) == sign extension
+static inline __m256i widen_x4(const int* p) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+// (v * m + a) & k per 32-bit lane; values stay far below int overflow, as in the scalar code
+static inline __m128i affine_mask_x4(__m128i v, int m, int a, int k) {
+    return _mm_and_si128(_mm_add_epi32(_mm_mullo_epi32(v, _mm_set1_epi32(m)), _mm_set1_epi32(a)),
+                         _mm_set1_epi32(k));
+}
+
+// 4 orders per step: strategy update selected per lane by blend (no branch on assign),
+// hash/mix in 64-bit lanes. Book writes stay scalar and in order so last-writer-wins
+// matches the scalar path. One relaxed fetch_add per order, like every other impl, so the
+// comparison measures the layout and the SIMD math, not fewer atomics.
+static inline void run_soa_simd_range(OrderSoA& s, const uint8_t* assign, size_t lo, size_t hi,
+                                      std::atomic<uint64_t>& checksum)
+{
+    size_t i = lo;
+    for (; i + 4 <= hi; i += 4) {
+        uint32_t a4; std::memcpy(&a4, assign + i, 4);
+        const __m128i is_a = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(a4))),
+                                             _mm_setzero_si128());
+
+        __m128i q  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s.qty[i]));
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s.price[i]));
+        q  = _mm_blendv_epi8(affine_mask_x4(q,  7, 2, 2047),  affine_mask_x4(q,  3, 1, 1023),  is_a);
+        px = _mm_blendv_epi8(affine_mask_x4(px, 9, 3, 65535), affine_mask_x4(px, 5, 7, 65535), is_a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&s.qty[i]),   q);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&s.price[i]), px);
+
+        __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s.id[i]));
+        h = _mm256_xor_si256(h, mul64_x4(widen_x4(&s.side[i]),
+                                         _mm256_set1_epi64x(static_cast<long long>(0x9e3779b97f4a7c15ULL))));
+        h = _mm256_add_epi64(h, mul64_x4(_mm256_cvtepi32_epi64(q),  _mm256_set1_epi64x(13)));
+        h = _mm256_xor_si256(h, mul64_x4(_mm256_cvtepi32_epi64(px), _mm256_set1_epi64x(101)));
+        h = _mm256_xor_si256(h, mul64_x4(widen_x4(&s.payload0[i]), _mm256_set1_epi64x(17)));
+        h = _mm256_add_epi64(h, mul64_x4(widen_x4(&s.payload1[i]), _mm256_set1_epi64x(23)));
+        const __m256i r = mix64_x4(h);
+
+        for (size_t k=i;k<i+4;++k) {
+            size_t idx = (static_cast<size_t>(s.id[k]) + static_cast<size_t>(s.side[k]) * 7) & (WorkPolicy::BOOK_SZ - 1);
+            WorkPolicy::s_book_qty[idx] = s.qty[k];
+            WorkPolicy::s_book_px[idx]  = s.price[k];
+        }
+        const int odd = _mm_movemask_ps(_mm_castsi128_ps(_mm_slli_epi32(px, 31)));
+        WorkPolicy::s_branch_counter += static_cast<uint64_t>(std::popcount(static_cast<unsigned>(odd)));
+
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), r);
+        for (uint64_t v : lanes) checksum.fetch_add(v, std::memory_order_relaxed);
+    }
+    for (; i < hi; ++i) checksum.fetch_add(run_soa_one(s, i, assign[i]), std::memory_order_relaxed);
+}
+#else
+static inline void run_soa_simd_range(OrderSoA& s, const uint8_t* assign, size_t lo, size_t hi,
+                                      std::atomic<uint64_t>& checksum)
+{
+    for (size_t i=lo;i<hi;++i) checksum.fetch_add(run_soa_one(s, i, assign[i]), std::memory_order_relaxed);
+}
+#endif
+
+static RunResult run_soa_simd(const std::vector<Order>& base,
+                              const std::vector<uint8_t>& assign)
+{
+    OrderSoA soa;
+    to_soa(base, soa);
+
+    std::atomic<uint64_t> checksum{0};
+    auto t0 = Clock::now();
+    run_soa_simd_range(soa, assign.data(), 0, soa.size(), checksum);
+    auto t1 = Clock::now();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(soa.size()) / static_cast<double>(ns));
+    return { ns, ops_s, checksum.load(std::memory_order_relaxed) };
+}
+
+// ---- Parallel mode ----
+// The order array is split into contiguous chunks, one per worker. WorkPolicy's book is
+// thread_local, so workers never share it. Reduction is either one shared atomic hit by
+// every order from every thread, or a per-thread local sum combined once at the end.
+enum class Reduce : int { SharedAtomic = 0, ThreadLocal = 1 };
+
+static const char* reduce_name(Reduce r) {
+    return r == Reduce::SharedAtomic ? "shared_atomic" : "thread_local";
+}
+
+// 64-byte aligned storage, so chunk edges on line multiples really are line boundaries
+template <typename T>
+struct CacheLineAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t kAlign{64};
+    CacheLineAllocator() = default;
+    template <typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), kAlign)); }
+    void deallocate(T* p, size_t) { ::operator delete(p, kAlign); }
+    template <typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+};
+using AlignedOrders = std::vector<Order, CacheLineAllocator<Order>>;
+
+// One cache line per worker: its local sum and its own start/end times
+struct alignas(64) WorkerSlot {
+    uint64_t sum = 0;
+    Clock::time_point t0, t1;
+};
+
+template <bool Virtual, Reduce R>
+static void process_chunk(AlignedOrders& orders, const std::vector<uint8_t>& assign,
+                          size_t lo, size_t hi, std::atomic<uint64_t>& shared, WorkerSlot& slot)
+{
+    StrategyA_V av; StrategyB_V bv;
+    StrategyA_NV an; StrategyB_NV bn;
+    Processor* procs[2] = { &av, &bv };
+    uint64_t local = 0;
+    for (size_t i=lo;i<hi;++i) {
+        uint64_t r;
+        if constexpr (Virtual) r = procs[assign[i]]->process(orders[i]);
+        else                   r = (assign[i] == 0) ? an.run(orders[i]) : bn.run(orders[i]);
+        if constexpr (R == Reduce::SharedAtomic) shared.fetch_add(r, std::memory_order_relaxed);
+        else                                     local += r;
+    }
+    slot.sum = local;
+}
+
+template <bool Virtual, Reduce R>
+static RunResult run_parallel(const std::vector<Order>& base,
+                              const std::vector<uint8_t>& assign, int threads)
+{
+    AlignedOrders orders(base.begin(), base.end());
+    const size_t n = orders.size();
+    // chunk edges on cache-line multiples (the buffer is 64-byte aligned) so neighbouring
+    // workers never share a line
+    static_assert(64 % sizeof(Order) == 0, "Order must tile a cache line");
+    constexpr size_t kLine = 64 / sizeof(Order);
+    const size_t chunk = ((n + threads - 1) / threads + kLine - 1) / kLine * kLine;
+
+    std::atomic<uint64_t> shared{0};
+    std::vector<WorkerSlot> slots(static_cast<size_t>(threads));
+    std::atomic<int>  ready{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> pool;
+    pool.reserve(static_cast<size_t>(threads));
+    for (int t=0;t<threads;++t) {
+        const size_t lo = std::min(n, static_cast<size_t>(t) * chunk);
+        const size_t hi = std::min(n, lo + chunk);
+        pool.emplace_back([&, lo, hi, t] {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            WorkerSlot& slot = slots[static_cast<size_t>(t)];
+            slot.t0 = Clock::now();
+            process_chunk<Virtual, R>(orders, assign, lo, hi, shared, slot);
+            slot.t1 = Clock::now();
+        });
+    }
+    while (ready.load(std::memory_order_acquire) < threads) std::this_thread::yield();
+
+    // timed inside the workers: first chunk started → last chunk finished. The main
+    // thread sleeps in join() instead of spinning on a core the workers need.
+    go.store(true, std::memory_order_release);
+    for (auto& th : pool) th.join();
+    uint64_t checksum = shared.load(std::memory_order_relaxed);
+    Clock::time_point t0 = slots[0].t0, t1 = slots[0].t1;
+    for (const auto& s : slots) {
+        checksum += s.sum;
+        t0 = std::min(t0, s.t0);
+        t1 = std::max(t1, s.t1);
+    }
+
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    double ops_s = (ns == 0) ? 0.0 : (1e9 * static_cast<double>(n) / static_cast<double>(ns));
+    return { ns, ops_s, checksum };
+}
+
+static RunResult run_parallel_dispatch(bool virtual_impl, Reduce r, const std::vector<Order>& base,
+                                       const std::vector<uint8_t>& assign, int threads)
+{
+    if (virtual_impl) {
+        return r == Reduce::SharedAtomic ? run_parallel<true,  Reduce::SharedAtomic>(base, assign, threads)
+                                         : run_parallel<true,  Reduce::ThreadLocal >(base, assign, threads);
+    }
+    return r == Reduce::SharedAtomic ? run_parallel<false, Reduce::SharedAtomic>(base, assign, threads)
+                                     : run_parallel<false, Reduce::ThreadLocal >(base, assign, threads);
+}
+
+static RunResult run_impl(int impl, const std::vector<Order>& base,
+                          const std::vector<uint8_t>& assign, OrderBatch& batch)
+{
+    switch (impl) {
+        case kNonVirtual:   return run_nonvirtual(base, assign);
+        case kVirtual:      return run_virtual(base, assign);
+        case kTypeSorted:   return run_typesorted(base, assign, batch);
+        case kFnTable:      return run_fntable(base, assign);
+        case kVariant:      return run_variant(base, assign);
+        case kComputedGoto: return run_computed_goto(base, assign);
+        case kSoaScalar:    return run_soa_scalar(base, assign);
+        case kSoaSimd:      return run_soa_simd(base, assign);
+    }
+    return { 0, 0.0, 0 };
+}
+
 static double median_ns(std::vector<uint64_t> v) {
     if (v.empty()) return 0.0;
     std::sort(v.begin(), v.end());
@@ -205,6 +629,7 @@ int main(int argc, char** argv) {
     size_t N = (argc >= 2) ? static_cast<size_t>(std::stoull(argv[1])) : 500'000;
     int repeats = (argc >= 3) ? std::stoi(argv[2]) : 10;
     std::string out_csv = (argc >= 4) ? argv[3] : "";
+    int max_threads = (argc >= 5) ? std::stoi(argv[4]) : 0;
 
     const size_t WARMUP_OPS = 1'000'000;
 
@@ -214,8 +639,12 @@ int main(int argc, char** argv) {
     std::string header = "pattern,impl,repeat,orders,elapsed_ns,ops_per_sec,checksum\n";
     std::cout << header;
 
+    StrategyA_V proto_a; StrategyB_V proto_b;
+    OrderBatch batch(proto_a, proto_b);
+    batch.reserve(N);
+
     struct Agg { std::vector<uint64_t> elapsed; std::vector<double> ops; };
-    Agg agg[3][2];
+    Agg agg[3][kNumImpls];
 
     for (int p_i = 0; p_i < 3; ++p_i) {
         Pattern p = static_cast<Pattern>(p_i);
@@ -243,24 +672,31 @@ int main(int argc, char** argv) {
                 uint64_t r = (warm_assign[wcnt % warm_assign.size()] == 0) ? an.run(o) : bn.run(o);
                 ++wcnt; return r;
             }, WARMUP_OPS/2);
+
+            for (int impl : { kTypeSorted, kFnTable, kVariant, kComputedGoto, kSoaScalar, kSoaSimd }) {
+                g_warmup_sink.fetch_add(run_impl(impl, warm_base, warm_assign, batch).checksum,
+                                        std::memory_order_relaxed);
+            }
         }
 
+        // virtual first, then nonvirtual: same row order as the original two-way CSV
+        static constexpr int kRunOrder[kNumImpls] = {
+            kVirtual, kNonVirtual, kTypeSorted, kFnTable, kVariant, kComputedGoto,
+            kSoaScalar, kSoaSimd };
         for (int r = 0; r < repeats; ++r) {
-            auto rv = run_virtual(base, assign);
-            agg[p_i][1].elapsed.push_back(rv.elapsed_ns);
-            agg[p_i][1].ops.push_back(rv.ops_per_sec);
-            std::cout << pattern_name(p) << ",virtual," << r << "," << N << ","
-                      << rv.elapsed_ns << "," << rv.ops_per_sec << "," << rv.checksum << "\n";
-
-            auto rn = run_nonvirtual(base, assign);
-            agg[p_i][0].elapsed.push_back(rn.elapsed_ns);
-            agg[p_i][0].ops.push_back(rn.ops_per_sec);
-            std::cout << pattern_name(p) << ",nonvirtual," << r << "," << N << ","
-                      << rn.elapsed_ns << "," << rn.ops_per_sec << "," << rn.checksum << "\n";
-
-            std::cerr << "[checksum] pattern=" << pattern_name(p)
-                      << " virtual=" << rv.checksum
-                      << " nonvirtual=" << rn.checksum << "\n";
+            uint64_t sums[kNumImpls] = {};
+            for (int impl : kRunOrder) {
+                auto res = run_impl(impl, base, assign, batch);
+                agg[p_i][impl].elapsed.push_back(res.elapsed_ns);
+                agg[p_i][impl].ops.push_back(res.ops_per_sec);
+                sums[impl] = res.checksum;
+                std::cout << pattern_name(p) << "," << impl_name(impl) << "," << r << "," << N << ","
+                          << res.elapsed_ns << "," << res.ops_per_sec << "," << res.checksum << "\n";
+            }
+
+            std::cerr << "[checksum] pattern=" << pattern_name(p);
+            for (int impl : kRunOrder) std::cerr << " " << impl_name(impl) << "=" << sums[impl];
+            std::cerr << "\n";
         }
     }
 
@@ -269,7 +705,7 @@ int main(int argc, char** argv) {
     }
 
     for (int p_i=0;p_i<3;++p_i) {
-        for (int impl=0;impl<2;++impl) {
+        for (int impl=0;impl<kNumImpls;++impl) {
             auto v = agg[p_i][impl].elapsed;
             auto o = agg[p_i][impl].ops;
             if (v.empty()) continue;
@@ -278,10 +714,51 @@ int main(int argc, char** argv) {
             double best_ops = *std::max_element(o.begin(), o.end());
             double med_ops  = (static_cast<double>(base.size()) * 1e9) / med;
             std::cerr << "[summary] pattern=" << pattern_name(static_cast<Pattern>(p_i))
-                      << " impl=" << (impl==1?"virtual":"nonvirtual")
+                      << " impl=" << impl_name(impl)
                       << " best_ns=" << best << " med_ns=" << (uint64_t)med
                       << " best_ops_s=" << best_ops << " med_ops_s=" << med_ops << "\n";
         }
     }
+
+    // ---- Parallel mode: scaling 1..max_threads, shared atomic vs thread-local sums ----
+    if (max_threads > 0) {
+        std::vector<int> counts;
+        for (int t=1;t<max_threads;t*=2) counts.push_back(t);
+        counts.push_back(max_threads);
+
+        for (int p_i=0;p_i<3;++p_i) {
+            Pattern p = static_cast<Pattern>(p_i);
+            std::vector<uint8_t> assign;
+            make_assign(assign, p, N, /*seed=*/12345);
+            const uint64_t expected = run_nonvirtual(base, assign).checksum;
+
+            for (int impl : { static_cast<int>(kNonVirtual), static_cast<int>(kVirtual) }) {
+                double one_thread_ops = 0.0;
+                for (int t : counts) {
+                    double med_ops[2] = {0.0, 0.0};
+                    bool ok = true;
+                    for (Reduce red : { Reduce::SharedAtomic, Reduce::ThreadLocal }) {
+                        std::vector<uint64_t> el;
+                        for (int r=0;r<repeats;++r) {
+                            auto res = run_parallel_dispatch(impl == kVirtual, red, base, assign, t);
+                            el.push_back(res.elapsed_ns);
+                            ok = ok && (res.checksum == expected);
+                        }
+                        med_ops[static_cast<int>(red)] = (static_cast<double>(N) * 1e9) / median_ns(el);
+                    }
+                    const double shared_ops = med_ops[static_cast<int>(Reduce::SharedAtomic)];
+                    const double local_ops  = med_ops[static_cast<int>(Reduce::ThreadLocal)];
+                    if (t == 1) one_thread_ops = local_ops;
+                    std::cerr << "[parallel] pattern=" << pattern_name(p)
+                              << " impl=" << impl_name(impl) << " threads=" << t
+                              << " " << reduce_name(Reduce::SharedAtomic) << "_ops_s=" << shared_ops
+                              << " " << reduce_name(Reduce::ThreadLocal) << "_ops_s=" << local_ops
+                              << " local_vs_shared=" << (local_ops / shared_ops) << "x"
+                              << " scaling=" << (local_ops / one_thread_ops) << "x"
+                              << " checksum=" << (ok ? "ok" : "MISMATCH") << "\n";
+                }
+            }
+        }
+    }
     return 0;
 }
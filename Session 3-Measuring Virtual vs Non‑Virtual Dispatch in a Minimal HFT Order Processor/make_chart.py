@@ -20,7 +20,11 @@ def main():
         data[key].append(ops)
 
     patterns = ['homogeneous', 'mixed', 'bursty']
-    impls = ['nonvirtual', 'virtual']  # order on chart
+    # known impls first in this order, anything else in the CSV after them
+    known = ['nonvirtual', 'virtual', 'typesorted', 'fntable', 'variant', 'computedgoto',
+             'soa_scalar', 'soa_simd']
+    present = {im for (_, im) in data}
+    impls = [im for im in known if im in present] + sorted(present - set(known))
 
     med = {}
     for p in patterns:
@@ -33,18 +37,16 @@ def main():
             med[(p,im)] = m
 
     x = range(len(patterns))
-    width = 0.35
+    width = 0.8 / max(1, len(impls))
 
-    fig = plt.figure(figsize=(7,4.5))
-    nv = [med[(p,'nonvirtual')] for p in patterns]
-    vv = [med[(p,'virtual')] for p in patterns]
-
-    plt.bar([i - width/2 for i in x], nv, width, label='non-virtual')
-    plt.bar([i + width/2 for i in x], vv, width, label='virtual')
+    fig = plt.figure(figsize=(max(7, 1.5 * len(impls) + 4), 4.5))
+    for k, im in enumerate(impls):
+        offset = (k - (len(impls) - 1) / 2) * width
+        plt.bar([i + offset for i in x], [med[(p, im)] for p in patterns], width, label=im)
 
     plt.xticks(list(x), patterns)
     plt.ylabel('Orders per second')
-    plt.title('Virtual vs Non-virtual Throughput (median across repeats)')
+    plt.title('Dispatch Throughput by Engine (median across repeats)')
     plt.legend()
     plt.tight_layout()
     plt.savefig(out_png, dpi=150)
@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// vtable pointer = first word of a polymorphic object (Itanium and MSVC ABIs, single
+// inheritance). -fno-rtti rules out typeid/dynamic_cast, and the vptr is exactly what
+// the indirect call dispatches on.
+inline const void* vptr_of(const void* obj) noexcept {
+    return *static_cast<const void* const*>(obj);
+}
+
+// 按具体类型分桶（计数排序），每个桶内用静态类型的紧凑循环调用 → 可内联、无间接跳转
+//
+// Items are bucketed by vtable pointer against exemplars of the registered Concrete
+// types; each bucket is then run with the item statically typed as that Concrete, so
+// calls through a `final` class are direct and inlinable. Unregistered types fall into
+// a last bucket that still dispatches virtually. Item indices are kept, so callers
+// write results to out[index] and output order is preserved.
+//
+// Also used by Session 3 (hft_assignment.cpp), which builds with -I pointing here.
+template <typename Base, typename... Concrete>
+class TypeSortedBatch {
+public:
+    static constexpr size_t kTypes    = sizeof...(Concrete);
+    static constexpr size_t kFallback = kTypes;
+
+    explicit TypeSortedBatch(const Concrete&... exemplars)
+        : vptrs_{ vptr_of(&exemplars)... } {}
+
+    // Size and touch the buffers up front so a timed bucketize() never page-faults
+    void reserve(size_t n) { index_.resize(n); item_.resize(n); }
+
+    // get(i) -> Base* for item i. Stable counting sort: order within a bucket is input order.
+    template <typename GetItem>
+    void bucketize(size_t n, GetItem&& get) {
+        index_.resize(n);
+        item_.resize(n);
+        bucketize_impl(n, get, std::make_index_sequence<kTypes + 1>{});
+    }
+
+    // f(index, Concrete&) for every item, one bucket (= one static type) at a time;
+    // f(index, Base&) for the fallback bucket.
+    template <typename F>
+    void for_each(F&& f) const {
+        run_buckets(f, std::index_sequence_for<Concrete...>{});
+        for (size_t p = begin_[kFallback]; p < begin_[kFallback + 1]; ++p)
+            f(index_[p], *item_[p]);
+    }
+
+    size_t bucket_size(size_t k) const { return begin_[k + 1] - begin_[k]; }
+
+private:
+    std::array<const void*, kTypes> vptrs_;
+    std::array<size_t, kTypes + 2>  begin_{};
+    std::vector<uint32_t>           index_;
+    std::vector<Base*>              item_;
+
+    // Two passes (count, scatter). Per-bucket counters and cursors are unrolled over K so
+    // they stay in registers: no branch on the item type and no store-to-load chain
+    // through a counter array when consecutive items share a bucket.
+    template <typename GetItem, size_t... K>
+    void bucketize_impl(size_t n, GetItem& get, std::index_sequence<K...>) {
+        std::array<size_t, kTypes + 1> cnt{};
+        for (size_t i = 0; i < n; ++i) {
+            const size_t k = kind_of(get(i));
+            ((cnt[K] += (k == K)), ...);
+        }
+        std::array<size_t, kTypes + 1> cur{};
+        begin_[0] = 0;
+        for (size_t k = 0; k <= kTypes; ++k) begin_[k + 1] = begin_[k] + cnt[k];
+        ((cur[K] = begin_[K]), ...);
+        for (size_t i = 0; i < n; ++i) {
+            Base* item = get(i);
+            const size_t k = kind_of(item);
+            const size_t pos = ((k == K ? cur[K] : 0) + ...);
+            ((cur[K] += (k == K)), ...);
+            index_[pos] = static_cast<uint32_t>(i);
+            item_[pos]  = item;
+        }
+    }
+
+    // Select without branching so mixed streams don't mispredict here instead
+    uint8_t kind_of(const Base* p) const noexcept {
+        const void* v = vptr_of(p);
+        uint8_t k = static_cast<uint8_t>(kFallback);
+        for (size_t j = 0; j < kTypes; ++j)
+            k = (vptrs_[j] == v) ? static_cast<uint8_t>(j) : k;
+        return k;
+    }
+
+    template <typename F, size_t... K>
+    void run_buckets(F& f, std::index_sequence<K...>) const {
+        (run_bucket<K, Concrete>(f), ...);
+    }
+
+    template <size_t K, typename C, typename F>
+    void run_bucket(F& f) const {
+        for (size_t p = begin_[K]; p < begin_[K + 1]; ++p)
+            f(index_[p], static_cast<C&>(*item_[p]));
+    }
+};
@@ -0,0 +1,342 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.hpp"
+
+#if defined(__linux__)
+  #include <sched.h>
+  #include <unistd.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <linux/perf_event.h>
+#endif
+
+//=============================
+// Runner configuration (filled from CLI flags in main)
+//=============================
+struct BenchConfig {
+    int         warmup   = 2;      // untimed passes before sampling
+    int         reps     = 15;     // timed samples per case
+    int         pin_cpu  = -1;     // <0: leave affinity alone
+    bool        counters = false;  // hardware counters via perf_event_open
+    std::string format   = "text"; // text | json | csv
+    std::string out;               // json/csv destination; empty = hft_bench.<format>
+};
+
+//=============================
+// Hardware counters (Linux only; silently unavailable elsewhere)
+//=============================
+enum Counter : int { kCycles = 0, kInstructions, kBranchMisses, kL1dMisses, kNumCounters };
+
+inline const char* counter_name(int c) {
+    switch (c) {
+        case kCycles:       return "cycles";
+        case kInstructions: return "instructions";
+        case kBranchMisses: return "branch_misses";
+        case kL1dMisses:    return "l1d_misses";
+    }
+    return "unknown";
+}
+
+class PerfCounters {
+public:
+    PerfCounters() { std::fill(fds_, fds_ + kNumCounters, -1); }
+    ~PerfCounters() { close_all(); }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Returns false when no counter could be opened (non-Linux, container,
+    // perf_event_paranoid too high). Individual counters may still be missing.
+    bool open() {
+#if defined(__linux__)
+        open_one(kCycles,        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_one(kInstructions,  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_one(kBranchMisses,  PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        open_one(kL1dMisses,     PERF_TYPE_HW_CACHE,
+                 PERF_COUNT_HW_CACHE_L1D
+                 | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+        for (int c = 0; c < kNumCounters; ++c) if (fds_[c] >= 0) return true;
+        return false;
+    }
+
+    bool has(int c) const { return fds_[c] >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        for (int c = 0; c < kNumCounters; ++c) {
+            if (fds_[c] < 0) continue;
+            ioctl(fds_[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds_[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Counts are scaled by enabled/running time in case the PMU multiplexed
+    void stop(double out[kNumCounters]) {
+        for (int c = 0; c < kNumCounters; ++c) out[c] = 0.0;
+#if defined(__linux__)
+        for (int c = 0; c < kNumCounters; ++c) {
+            if (fds_[c] < 0) continue;
+            ioctl(fds_[c], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t buf[3] = {0, 0, 0}; // value, time_enabled, time_running
+            if (read(fds_[c], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) continue;
+            out[c] = (buf[2] == 0) ? 0.0
+                   : static_cast<double>(buf[0]) * static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+        }
+#endif
+    }
+
+private:
+    int fds_[kNumCounters];
+
+#if defined(__linux__)
+    void open_one(int slot, uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds_[slot] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    void close_all() {
+#if defined(__linux__)
+        for (int c = 0; c < kNumCounters; ++c) if (fds_[c] >= 0) ::close(fds_[c]);
+#endif
+        std::fill(fds_, fds_ + kNumCounters, -1);
+    }
+};
+
+// Pin the calling thread to one CPU (Linux). Returns false if not applied.
+inline bool pin_to_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+//=============================
+// Sample statistics
+//=============================
+struct SampleStats {
+    double median = 0, mean = 0, stddev = 0;
+    double ci_lo  = 0, ci_hi = 0;   // 95% CI of the median (order statistics)
+    double min    = 0, max   = 0;
+    int    n      = 0;              // samples kept
+    int    outliers = 0;            // dropped by Tukey fences (1.5 IQR)
+};
+
+inline double quantile_sorted(const std::vector<double>& v, double q) {
+    if (v.empty()) return 0.0;
+    const double pos = q * static_cast<double>(v.size() - 1);
+    const size_t lo  = static_cast<size_t>(pos);
+    const size_t hi  = std::min(lo + 1, v.size() - 1);
+    return v[lo] + (v[hi] - v[lo]) * (pos - static_cast<double>(lo));
+}
+
+inline SampleStats summarize(std::vector<double> v) {
+    SampleStats s;
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+
+    // 去除离群值：Tukey fences
+    const double q1 = quantile_sorted(v, 0.25);
+    const double q3 = quantile_sorted(v, 0.75);
+    const double lo_fence = q1 - 1.5 * (q3 - q1);
+    const double hi_fence = q3 + 1.5 * (q3 - q1);
+    std::vector<double> kept;
+    kept.reserve(v.size());
+    for (double x : v) if (x >= lo_fence && x <= hi_fence) kept.push_back(x);
+    if (kept.empty()) kept = v;
+
+    const size_t n = kept.size();
+    s.n        = static_cast<int>(n);
+    s.outliers = static_cast<int>(v.size() - n);
+    s.min      = kept.front();
+    s.max      = kept.back();
+    s.median   = quantile_sorted(kept, 0.5);
+
+    double sum = 0.0;
+    for (double x : kept) sum += x;
+    s.mean = sum / static_cast<double>(n);
+    double sq = 0.0;
+    for (double x : kept) sq += (x - s.mean) * (x - s.mean);
+    s.stddev = (n > 1) ? std::sqrt(sq / static_cast<double>(n - 1)) : 0.0;
+
+    // Distribution-free CI for the median: ranks n/2 ± 1.96*sqrt(n)/2
+    const double half = 1.96 * std::sqrt(static_cast<double>(n)) * 0.5;
+    const double mid  = static_cast<double>(n) * 0.5;
+    const long lo_rank = std::max(0L, static_cast<long>(std::floor(mid - half)));
+    const long hi_rank = std::min(static_cast<long>(n) - 1, static_cast<long>(std::ceil(mid + half)));
+    s.ci_lo = kept[static_cast<size_t>(lo_rank)];
+    s.ci_hi = kept[static_cast<size_t>(hi_rank)];
+    return s;
+}
+
+//=============================
+// Runner
+//=============================
+struct BenchResult {
+    std::string name;
+    double      ops_per_pass = 0;
+    SampleStats ns_per_op;
+    bool        has_counter[kNumCounters] = {};
+    double      counter_per_op[kNumCounters] = {}; // median across reps
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(BenchConfig cfg) : cfg_(std::move(cfg)) {
+        if (cfg_.reps < 1) cfg_.reps = 1;
+        if (cfg_.pin_cpu >= 0) {
+            pinned_ = pin_to_cpu(cfg_.pin_cpu);
+            if (!pinned_) std::fprintf(stderr, "[bench] could not pin to cpu %d\n", cfg_.pin_cpu);
+        }
+        if (cfg_.counters) {
+            counters_ok_ = perf_.open();
+            if (!counters_ok_)
+                std::fprintf(stderr, "[bench] perf_event_open unavailable (check perf_event_paranoid)\n");
+        }
+    }
+
+    const BenchConfig& config() const { return cfg_; }
+
+    // `pass` runs one full pass over the workload and returns something to sink.
+    // `ops_per_pass` converts pass time into ns/op.
+    template <typename F>
+    BenchResult run(const char* name, double ops_per_pass, F&& pass) {
+        for (int w = 0; w < cfg_.warmup; ++w) {
+            auto v = pass();
+            do_not_optimize_away(v);
+        }
+
+        std::vector<double> ns;
+        ns.reserve(static_cast<size_t>(cfg_.reps));
+        std::vector<double> per_counter[kNumCounters];
+        double counts[kNumCounters];
+
+        for (int r = 0; r < cfg_.reps; ++r) {
+            if (counters_ok_) perf_.start();
+            Timer t;
+            t.start();
+            auto v = pass();
+            const double el = t.stop_ns();
+            if (counters_ok_) {
+                perf_.stop(counts);
+                for (int c = 0; c < kNumCounters; ++c) per_counter[c].push_back(counts[c] / ops_per_pass);
+            }
+            do_not_optimize_away(v);
+            ns.push_back(el / ops_per_pass);
+        }
+
+        BenchResult res;
+        res.name         = name;
+        res.ops_per_pass = ops_per_pass;
+        res.ns_per_op    = summarize(ns);
+        for (int c = 0; c < kNumCounters && counters_ok_; ++c) {
+            res.has_counter[c] = perf_.has(c);
+            if (res.has_counter[c]) {
+                std::sort(per_counter[c].begin(), per_counter[c].end());
+                res.counter_per_op[c] = quantile_sorted(per_counter[c], 0.5);
+            }
+        }
+        print_text(res);
+        results_.push_back(res);
+        return res;
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+    // Writes json/csv per config; no-op for text (already printed per case)
+    void emit() const {
+        if (cfg_.format != "json" && cfg_.format != "csv") return;
+        const std::string path = cfg_.out.empty() ? "hft_bench." + cfg_.format : cfg_.out;
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "[bench] cannot open %s\n", path.c_str());
+            return;
+        }
+        if (cfg_.format == "json") emit_json(f);
+        else                       emit_csv(f);
+        std::fclose(f);
+        std::printf("Wrote %s\n", path.c_str());
+    }
+
+private:
+    BenchConfig              cfg_;
+    PerfCounters             perf_;
+    bool                     pinned_      = false;
+    bool                     counters_ok_ = false;
+    std::vector<BenchResult> results_;
+
+    static void print_text(const BenchResult& r) {
+        const SampleStats& s = r.ns_per_op;
+        std::printf("%-18s median: %8.3f ns/op  95%% CI [%.3f, %.3f]  min %.3f  sd %.3f  (n=%d, %d outliers)\n",
+                    r.name.c_str(), s.median, s.ci_lo, s.ci_hi, s.min, s.stddev, s.n, s.outliers);
+        if (!r.has_counter[kCycles] && !r.has_counter[kInstructions]) return;
+        const double cyc = r.counter_per_op[kCycles];
+        const double ins = r.counter_per_op[kInstructions];
+        std::printf("%-18s cycles/op: %.2f  IPC: %.2f  br-miss/op: %.4f  L1d-miss/op: %.4f\n",
+                    "", cyc, cyc > 0 ? ins / cyc : 0.0,
+                    r.counter_per_op[kBranchMisses], r.counter_per_op[kL1dMisses]);
+    }
+
+    void emit_json(FILE* f) const {
+        std::fprintf(f, "{\n  \"config\": {\"warmup\": %d, \"reps\": %d, \"pin_cpu\": %d, \"pinned\": %s, \"counters\": %s},\n",
+                     cfg_.warmup, cfg_.reps, cfg_.pin_cpu, pinned_ ? "true" : "false",
+                     counters_ok_ ? "true" : "false");
+        std::fprintf(f, "  \"results\": [\n");
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const BenchResult& r = results_[i];
+            const SampleStats& s = r.ns_per_op;
+            std::fprintf(f, "    {\"name\": \"%s\", \"ops_per_pass\": %.0f, \"median_ns\": %.6f, "
+                            "\"ci95_lo_ns\": %.6f, \"ci95_hi_ns\": %.6f, \"mean_ns\": %.6f, "
+                            "\"stddev_ns\": %.6f, \"min_ns\": %.6f, \"max_ns\": %.6f, "
+                            "\"samples\": %d, \"outliers\": %d",
+                         r.name.c_str(), r.ops_per_pass, s.median, s.ci_lo, s.ci_hi, s.mean,
+                         s.stddev, s.min, s.max, s.n, s.outliers);
+            for (int c = 0; c < kNumCounters; ++c) {
+                if (r.has_counter[c]) std::fprintf(f, ", \"%s_per_op\": %.6f", counter_name(c), r.counter_per_op[c]);
+            }
+            std::fprintf(f, "}%s\n", (i + 1 < results_.size()) ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+    }
+
+    void emit_csv(FILE* f) const {
+        std::fprintf(f, "name,ops_per_pass,median_ns,ci95_lo_ns,ci95_hi_ns,mean_ns,stddev_ns,min_ns,max_ns,samples,outliers");
+        for (int c = 0; c < kNumCounters; ++c) std::fprintf(f, ",%s_per_op", counter_name(c));
+        std::fprintf(f, "\n");
+        for (const BenchResult& r : results_) {
+            const SampleStats& s = r.ns_per_op;
+            std::fprintf(f, "%s,%.0f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d",
+                         r.name.c_str(), r.ops_per_pass, s.median, s.ci_lo, s.ci_hi, s.mean,
+                         s.stddev, s.min, s.max, s.n, s.outliers);
+            for (int c = 0; c < kNumCounters; ++c) {
+                if (r.has_counter[c]) std::fprintf(f, ",%.6f", r.counter_per_op[c]);
+                else                  std::fprintf(f, ",");
+            }
+            std::fprintf(f, "\n");
+        }
+    }
+};
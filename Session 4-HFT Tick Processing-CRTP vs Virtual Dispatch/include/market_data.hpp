@@ -1,27 +1,67 @@
 #pragma once
 #include <cstdint>
 
-struct Quote {
-    double bid;
-    double ask;
-    double bid_qty;
-    double ask_qty;
+template <typename T>
+struct BasicQuote {
+    T bid;
+    T ask;
+    T bid_qty;
+    T ask_qty;
+};
+
+using Quote  = BasicQuote<double>;  // reference precision
+using QuoteF = BasicQuote<float>;   // float32: 2x SIMD lanes
+
+// Fixed-point quote: prices in integer ticks, sizes in integer lots
+struct TickQuote {
+    int32_t bid;
+    int32_t ask;
+    int32_t bid_qty;
+    int32_t ask_qty;
 };
 
 // --- Pure math helpers (header-only, likely to inline) ---
 // 使用倒数乘法（branchless tweak）
-inline double mid(const Quote& q) noexcept {
-    return (q.bid + q.ask) * 0.5;
+template <typename T>
+inline T mid(const BasicQuote<T>& q) noexcept {
+    return (q.bid + q.ask) * T(0.5);
 }
 
-inline double microprice(const Quote& q) noexcept {
-    const double denom = q.bid_qty + q.ask_qty; // Assumption: > 0 in synthetic stream
-    const double inv   = 1.0 / denom;
+template <typename T>
+inline T microprice(const BasicQuote<T>& q) noexcept {
+    const T denom = q.bid_qty + q.ask_qty; // Assumption: > 0 in synthetic stream
+    const T inv   = T(1) / denom;
     return (q.bid * q.ask_qty + q.ask * q.bid_qty) * inv;
 }
 
-inline double imbalance(const Quote& q) noexcept {
-    const double denom = q.bid_qty + q.ask_qty; // Assumption: > 0
-    const double inv   = 1.0 / denom;
+template <typename T>
+inline T imbalance(const BasicQuote<T>& q) noexcept {
+    const T denom = q.bid_qty + q.ask_qty; // Assumption: > 0
+    const T inv   = T(1) / denom;
     return (q.bid_qty - q.ask_qty) * inv;
 }
+
+// --- Fixed-point helpers (Q16: value * 2^16) ---
+// 价格以 tick 为单位；microprice 与 imbalance 共用同一次整数除法
+constexpr int     kFxShift = 16;
+constexpr int64_t kFxOne   = int64_t(1) << kFxShift;
+
+// bid_qty / (bid_qty + ask_qty) in Q16
+inline int64_t bid_share_fx(const TickQuote& q) noexcept {
+    const int64_t denom = int64_t(q.bid_qty) + q.ask_qty; // Assumption: > 0
+    return (int64_t(q.bid_qty) << kFxShift) / denom;
+}
+
+inline int64_t mid_fx(const TickQuote& q) noexcept {
+    return (int64_t(q.bid) + q.ask) << (kFxShift - 1);
+}
+
+// microprice = bid + spread * bid_share (offset form: no 64-bit overflow)
+inline int64_t microprice_fx(const TickQuote& q) noexcept {
+    return (int64_t(q.bid) << kFxShift) + (int64_t(q.ask) - q.bid) * bid_share_fx(q);
+}
+
+// imbalance = 2 * bid_share - 1
+inline int64_t imbalance_fx(const TickQuote& q) noexcept {
+    return 2 * bid_share_fx(q) - kFxOne;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "market_data.hpp"
+#include "utils.hpp"
+
+//=============================
+// Signal → order pipeline
+// bundle signal → thresholds → position/notional limits → preallocated order buffer
+//=============================
+enum class OrderSide : uint8_t { Buy, Sell };
+
+struct PipelineOrder {
+    uint32_t  tick;   // index of the triggering tick
+    OrderSide side;
+    int32_t   qty;
+    double    price;  // marketable: ask for buys, bid for sells
+};
+
+struct PipelineConfig {
+    double  buy_threshold  =  0.60;      // bundle signal above → buy
+    double  sell_threshold = -0.60;      // bundle signal below → sell
+    int32_t order_qty      = 100;
+    int32_t max_position   = 1'000;      // |position| cap (shares)
+    double  max_notional   = 150'000.0;  // |position| * mid cap
+};
+
+// Fixed-capacity sink: never reallocates on the hot path, rejects when full
+class OrderBuffer {
+public:
+    explicit OrderBuffer(size_t capacity) : buf_(capacity) {}
+
+    inline bool push(const PipelineOrder& o) noexcept {
+        if (size_ == buf_.size()) return false;
+        buf_[size_++] = o;
+        return true;
+    }
+    inline void clear() noexcept { size_ = 0; }
+    inline size_t size() const noexcept { return size_; }
+    inline const PipelineOrder& operator[](size_t i) const noexcept { return buf_[i]; }
+
+private:
+    std::vector<PipelineOrder> buf_;
+    size_t size_ = 0;
+};
+
+struct PipelineStats {
+    uint64_t orders       = 0;
+    uint64_t buys         = 0;
+    uint64_t sells        = 0;
+    uint64_t risk_rejects = 0; // signal fired but a limit blocked it
+    uint64_t buffer_full  = 0;
+    int32_t  position     = 0; // assumes immediate fills
+};
+
+// SignalFn: double(const Quote&) — a virtual bundle or a StaticBundle wrapped in a lambda,
+// so the CRTP-vs-virtual cost is measured on the full tick-to-order path.
+template <typename SignalFn>
+class SignalPipeline {
+public:
+    SignalPipeline(SignalFn fn, const PipelineConfig& cfg, size_t max_ticks, size_t order_capacity)
+        : fn_(fn), cfg_(cfg), orders_(order_capacity), latency_(max_ticks) {}
+
+    // One pass over the stream; state is reset so every pass is identical.
+    // Returns the final position so the caller can sink it.
+    int32_t run(const std::vector<Quote>& ticks) {
+        stats_ = PipelineStats{};
+        orders_.clear();
+        const uint32_t n = static_cast<uint32_t>(std::min(ticks.size(), latency_.size()));
+        for (uint32_t i = 0; i < n; ++i) on_tick(ticks[i], i);
+        return stats_.position;
+    }
+
+    const PipelineStats&         stats()   const { return stats_; }
+    const OrderBuffer&           orders()  const { return orders_; }
+    const std::vector<uint32_t>& latency() const { return latency_; } // cycle_now() units
+
+private:
+    SignalFn              fn_;
+    PipelineConfig        cfg_;
+    OrderBuffer           orders_;
+    std::vector<uint32_t> latency_;
+    PipelineStats         stats_;
+
+    inline void on_tick(const Quote& q, uint32_t i) {
+        const uint64_t t0 = cycle_now();
+        const double sig = fn_(q);
+        const int dir = (sig > cfg_.buy_threshold) - (sig < cfg_.sell_threshold);
+        if (dir != 0) try_order(q, i, dir);
+        latency_[i] = static_cast<uint32_t>(cycle_now() - t0);
+    }
+
+    inline void try_order(const Quote& q, uint32_t i, int dir) {
+        const int32_t new_pos = stats_.position + dir * cfg_.order_qty;
+        const int32_t abs_pos = new_pos < 0 ? -new_pos : new_pos;
+        if (abs_pos > cfg_.max_position || abs_pos * mid(q) > cfg_.max_notional) {
+            ++stats_.risk_rejects;
+            return;
+        }
+        const PipelineOrder o{ i, dir > 0 ? OrderSide::Buy : OrderSide::Sell,
+                               cfg_.order_qty, dir > 0 ? q.ask : q.bid };
+        if (!orders_.push(o)) {
+            ++stats_.buffer_full;
+            return;
+        }
+        stats_.position = new_pos;
+        ++stats_.orders;
+        if (dir > 0) ++stats_.buys; else ++stats_.sells;
+    }
+};
+
+template <typename SignalFn>
+SignalPipeline<SignalFn> make_pipeline(SignalFn fn, const PipelineConfig& cfg,
+                                       size_t max_ticks, size_t order_capacity) {
+    return SignalPipeline<SignalFn>(fn, cfg, max_ticks, order_capacity);
+}
+
+// Tick-to-order latency percentiles (all ticks, including no-order ticks)
+inline void report_latency(const char* name, const std::vector<uint32_t>& lat, double cyc_per_ns) {
+    if (lat.empty()) return;
+    std::vector<uint32_t> v(lat);
+    auto pct = [&](double p) {
+        const size_t k = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+        std::nth_element(v.begin(), v.begin() + static_cast<long>(k), v.end());
+        return static_cast<double>(v[k]) / cyc_per_ns;
+    };
+    const double p50 = pct(0.50), p90 = pct(0.90), p99 = pct(0.99), p999 = pct(0.999);
+    const double mx  = static_cast<double>(*std::max_element(v.begin(), v.end())) / cyc_per_ns;
+    std::printf("%-18s tick->order ns  p50: %.1f  p90: %.1f  p99: %.1f  p99.9: %.1f  max: %.1f\n",
+                name, p50, p90, p99, p999, mx);
+}
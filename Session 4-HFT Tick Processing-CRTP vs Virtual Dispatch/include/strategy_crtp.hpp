@@ -25,3 +25,17 @@ struct SignalStrategyCRTP : public StrategyBase<SignalStrategyCRTP> {
         return alpha1 * (mp - m) + alpha2 * imb;
     }
 };
+
+// Same behavior as SpreadStrategyVirtual but via CRTP
+struct SpreadStrategyCRTP : public StrategyBase<SpreadStrategyCRTP> {
+    double alpha1;
+    double alpha2;
+
+    explicit SpreadStrategyCRTP(double a1, double a2)
+        : alpha1(a1), alpha2(a2) {}
+
+    inline double on_tick_impl(const Quote& q) {
+        const double m = mid(q);
+        return alpha1 * (q.ask - q.bid) / m - alpha2 * imbalance(q);
+    }
+};
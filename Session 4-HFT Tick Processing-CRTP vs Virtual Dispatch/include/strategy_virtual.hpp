@@ -21,3 +21,17 @@ struct SignalStrategyVirtual final : IStrategy {
         return alpha1 * (mp - m) + alpha2 * imb;
     }
 };
+
+// Second concrete type for mixed strategy sets: relative spread against imbalance
+struct SpreadStrategyVirtual final : IStrategy {
+    double alpha1;
+    double alpha2;
+
+    explicit SpreadStrategyVirtual(double a1, double a2)
+        : alpha1(a1), alpha2(a2) {}
+
+    double on_tick(const Quote& q) override {
+        const double m = mid(q);
+        return alpha1 * (q.ask - q.bid) / m - alpha2 * imbalance(q);
+    }
+};
@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+# Build base / lto / pgo-gen / pgo-use variants of hft, train the PGO build on the
+# benchmark workload, then print median ns/op side by side.
+# Usage: ./pgo_compare.sh [n_ticks] [reps] [train_ticks]
+set -euo pipefail
+cd "$(dirname "$0")"
+
+N=${1:-5000000}
+REPS=${2:-11}
+TRAIN=${3:-2000000}
+OUT=build/compare
+mkdir -p "$OUT"
+
+bench() { # binary csv
+  "$1" "$N" 1 --reps="$REPS" --format=csv --out="$2" > /dev/null
+}
+
+for v in base lto; do
+  cmake --preset "$v" > /dev/null
+  cmake --build --preset "$v"
+  bench "build/$v/hft" "$OUT/$v.csv"
+done
+
+# Instrumented build: measure its overhead, then train on the same workload
+rm -rf build/pgo/pgo-data
+cmake --preset pgo-gen > /dev/null
+cmake --build --preset pgo-gen
+bench build/pgo/hft "$OUT/pgo-gen.csv"
+rm -rf build/pgo/pgo-data
+build/pgo/hft "$TRAIN" 1 --reps=3 > /dev/null
+
+if ls build/pgo/pgo-data/*.profraw > /dev/null 2>&1; then
+  llvm-profdata merge -o build/pgo/pgo-data/hft.profdata build/pgo/pgo-data/*.profraw
+fi
+
+cmake --preset pgo-use > /dev/null
+cmake --build --preset pgo-use
+bench build/pgo/hft "$OUT/pgo-use.csv"
+
+echo
+awk -F, '
+  FNR == 1 { f++; next }
+  { if (f == 1) order[++n] = $1; ns[f, $1] = $3 }
+  END {
+    printf "%-18s %10s %10s %10s %10s %9s\n", "median ns/op", "base", "lto", "pgo-gen", "pgo-use", "pgo/base"
+    for (i = 1; i <= n; i++) {
+      k = order[i]
+      printf "%-18s %10.3f %10.3f %10.3f %10.3f ", k, ns[1,k], ns[2,k], ns[3,k], ns[4,k]
+      if (ns[4,k] > 0) printf "%8.2fx\n", ns[1,k] / ns[4,k]; else printf "%9s\n", "-"
+    }
+  }' "$OUT/base.csv" "$OUT/lto.csv" "$OUT/pgo-gen.csv" "$OUT/pgo-use.csv"
@@ -1,13 +1,19 @@
 #include <vector>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "market_data.hpp"
 #include "utils.hpp"
+#include "bench_runner.hpp"
 #include "strategy_virtual.hpp"
 #include "strategy_crtp.hpp"
+#include "strategy_aggregators.hpp"
+#include "order_pipeline.hpp"
+#include "batch_dispatch.hpp"
 
 //=============================
 // Free function baseline (control)
@@ -41,9 +47,11 @@ static void generate_ticks(std::vector<Quote>& out, uint32_t n, uint32_t seed) {
 }
 
 // SoA layout for extension
-struct QuotesSoA {
-    std::vector<double> bid, ask, bid_qty, ask_qty;
+template <typename T>
+struct BasicQuotesSoA {
+    std::vector<T> bid, ask, bid_qty, ask_qty;
 };
+using QuotesSoA = BasicQuotesSoA<double>;
 
 static void generate_ticks_soa(QuotesSoA& q, uint32_t n, uint32_t seed) {
     q.bid.resize(n); q.ask.resize(n);
@@ -62,16 +70,11 @@ static void generate_ticks_soa(QuotesSoA& q, uint32_t n, uint32_t seed) {
 }
 
 //=============================
-// Bench harness (AoS)
+// Bench passes (AoS) — timed by BenchRunner
 //=============================
 template <typename F>
-static double run_bench(const char* name,
-                        const std::vector<Quote>& ticks,
-                        F&& func,
-                        int iters)
+static double pass_aos(const std::vector<Quote>& ticks, F&& func, int iters)
 {
-    Timer t;
-    t.start();
     volatile double sink = 0.0;
     for (int r = 0; r < iters; ++r) {
         for (const auto& q : ticks) {
@@ -80,21 +83,14 @@ static double run_bench(const char* name,
             sink += s * 1e-9; // keep it small
         }
     }
-    double ns = t.stop_ns();
-    std::printf("%-18s time: %.3f ms sink=%.6f\n", name, ns / 1e6, sink);
-    return ns;
+    return sink;
 }
 
 //=============================
-// Bench harness (SoA extension)
+// Bench passes (SoA extension)
 //=============================
-static double run_bench_soa(const QuotesSoA& q,
-                            double a1, double a2,
-                            int iters,
-                            const char* name = "soa_baseline")
+static double pass_soa(const QuotesSoA& q, double a1, double a2, int iters)
 {
-    Timer t;
-    t.start();
     volatile double sink = 0.0;
     size_t n = q.bid.size();
     for (int r = 0; r < iters; ++r) {
@@ -109,21 +105,166 @@ static double run_bench_soa(const QuotesSoA& q,
             sink += s * 1e-9;
         }
     }
-    double ns = t.stop_ns();
-    std::printf("%-18s time: %.3f ms sink=%.6f\n", name, ns / 1e6, sink);
-    return ns;
+    return sink;
 }
 
 //=============================
-// Extension: Heterogeneous composition (Virtual multi)
+// Extension: Precision variants (float32 / Q16 fixed-point)
 //=============================
-static double run_virtual_multi(const std::vector<Quote>& ticks, int iters) {
-    SignalStrategyVirtual s1(0.70, 0.30);
-    SignalStrategyVirtual s2(0.60, 0.40);
-    SignalStrategyVirtual s3(0.80, 0.20);
-    std::vector<IStrategy*> strategies = { &s1, &s2, &s3 };
+static constexpr double kTickSize = 1e-4; // 0.01 cent; synthetic spreads are 5–200 ticks
+
+template <typename T>
+inline T signal_typed(const BasicQuote<T>& q, T a1, T a2) {
+    const T mp  = microprice(q);
+    const T m   = mid(q);
+    const T imb = imbalance(q);
+    return a1 * (mp - m) + a2 * imb;
+}
+
+// 定点特征，最后一步在 double 中合成（a1 按 tick 缩放）
+inline double signal_fx(const TickQuote& q, double a1, double a2) {
+    // inlined, the helpers share one bid_share_fx division
+    const int64_t dmp = microprice_fx(q) - mid_fx(q);
+    const int64_t imb = imbalance_fx(q);
+    return (a1 * kTickSize * double(dmp) + a2 * double(imb)) * (1.0 / kFxOne);
+}
 
-    Timer t; t.start();
+// Snap onto the tick/lot grid so every precision sees identical inputs
+static void quantize_ticks(const std::vector<Quote>& in,
+                           std::vector<TickQuote>& fx,
+                           std::vector<Quote>& dbl,
+                           std::vector<QuoteF>& flt)
+{
+    const size_t n = in.size();
+    fx.resize(n); dbl.resize(n); flt.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const TickQuote t{
+            static_cast<int32_t>(std::lround(in[i].bid / kTickSize)),
+            static_cast<int32_t>(std::lround(in[i].ask / kTickSize)),
+            static_cast<int32_t>(std::lround(in[i].bid_qty)),
+            static_cast<int32_t>(std::lround(in[i].ask_qty))
+        };
+        fx[i]  = t;
+        dbl[i] = Quote{ t.bid * kTickSize, t.ask * kTickSize,
+                        double(t.bid_qty), double(t.ask_qty) };
+        flt[i] = QuoteF{ float(dbl[i].bid), float(dbl[i].ask),
+                         float(dbl[i].bid_qty), float(dbl[i].ask_qty) };
+    }
+}
+
+template <typename T, typename Q>
+static void to_soa(const std::vector<Q>& in, BasicQuotesSoA<T>& out) {
+    const size_t n = in.size();
+    out.bid.resize(n); out.ask.resize(n);
+    out.bid_qty.resize(n); out.ask_qty.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        out.bid[i]     = static_cast<T>(in[i].bid);
+        out.ask[i]     = static_cast<T>(in[i].ask);
+        out.bid_qty[i] = static_cast<T>(in[i].bid_qty);
+        out.ask_qty[i] = static_cast<T>(in[i].ask_qty);
+    }
+}
+
+// Writes one signal per tick into `out` so the loop auto-vectorizes
+// (float: 8 lanes per AVX2 register vs 4 for double)
+template <typename T>
+static void signal_soa(const BasicQuotesSoA<T>& q, T a1, T a2, T* __restrict out) {
+    const T* __restrict bid = q.bid.data();
+    const T* __restrict ask = q.ask.data();
+    const T* __restrict bq  = q.bid_qty.data();
+    const T* __restrict aq  = q.ask_qty.data();
+    const size_t n = q.bid.size();
+    for (size_t i = 0; i < n; ++i) {
+        const T inv = T(1) / (bq[i] + aq[i]);
+        const T mp  = (bid[i] * aq[i] + ask[i] * bq[i]) * inv;
+        const T m   = (bid[i] + ask[i]) * T(0.5);
+        const T imb = (bq[i] - aq[i]) * inv;
+        out[i] = a1 * (mp - m) + a2 * imb;
+    }
+}
+
+// x86 has no SIMD integer divide, so this path stays scalar on the division
+static void signal_soa_fx(const BasicQuotesSoA<int32_t>& q, double a1, double a2,
+                          double* __restrict out)
+{
+    const size_t n = q.bid.size();
+    for (size_t i = 0; i < n; ++i) {
+        const TickQuote t{ q.bid[i], q.ask[i], q.bid_qty[i], q.ask_qty[i] };
+        out[i] = signal_fx(t, a1, a2);
+    }
+}
+
+struct ErrorStats { double max_abs; double rms; };
+
+template <typename T>
+static ErrorStats error_vs(const std::vector<double>& ref, const std::vector<T>& got) {
+    double max_abs = 0.0, sq = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        const double e = std::fabs(double(got[i]) - ref[i]);
+        if (e > max_abs) max_abs = e;
+        sq += e * e;
+    }
+    return { max_abs, std::sqrt(sq / double(ref.size())) };
+}
+
+template <typename Out, typename F>
+static double pass_kernel(std::vector<Out>& out, F&& kernel, int iters) {
+    volatile double sink = 0.0;
+    if (out.empty()) return sink;  // 0 ticks: nothing to run or fold
+    for (int r = 0; r < iters; ++r) {
+        kernel(out.data());
+        do_not_optimize_away(out.data());
+        sink = sink + double(out[static_cast<size_t>(r) % out.size()]) * 1e-9;
+    }
+    return sink;
+}
+
+static void run_precision_study(BenchRunner& runner, const std::vector<Quote>& ticks,
+                                double a1, double a2, int iters)
+{
+    std::vector<TickQuote> fx;
+    std::vector<Quote>     dbl;
+    std::vector<QuoteF>    flt;
+    quantize_ticks(ticks, fx, dbl, flt);
+
+    // Accuracy: scalar kernels vs the double reference on the same grid
+    const size_t n = ticks.size();
+    std::vector<double> ref(n), got_fx(n);
+    std::vector<float>  got_f32(n);
+    for (size_t i = 0; i < n; ++i) {
+        ref[i]     = signal_typed(dbl[i], a1, a2);
+        got_f32[i] = signal_typed(flt[i], float(a1), float(a2));
+        got_fx[i]  = signal_fx(fx[i], a1, a2);
+    }
+    const ErrorStats e32 = error_vs(ref, got_f32);
+    const ErrorStats efx = error_vs(ref, got_fx);
+    const ErrorStats eref = error_vs(ref, std::vector<double>(n, 0.0)); // signal scale
+    std::printf("%-18s max_abs_err: %.3e  rms_err: %.3e  (signal rms %.3e)\n",
+                "accuracy_f32", e32.max_abs, e32.rms, eref.rms);
+    std::printf("%-18s max_abs_err: %.3e  rms_err: %.3e  (signal rms %.3e)\n",
+                "accuracy_fx_q16", efx.max_abs, efx.rms, eref.rms);
+
+    // Throughput: SoA kernels writing a signal per tick
+    BasicQuotesSoA<double>  s64; to_soa(dbl, s64);
+    BasicQuotesSoA<float>   s32; to_soa(flt, s32);
+    BasicQuotesSoA<int32_t> sfx; to_soa(fx,  sfx);
+    std::vector<double> out64(n), outfx(n);
+    std::vector<float>  out32(n);
+
+    const double ops = static_cast<double>(n) * iters;
+    runner.run("soa_f64", ops, [&] {
+        return pass_kernel(out64, [&](double* o) { signal_soa(s64, a1, a2, o); }, iters); });
+    runner.run("soa_f32", ops, [&] {
+        return pass_kernel(out32, [&](float* o) { signal_soa(s32, float(a1), float(a2), o); }, iters); });
+    runner.run("soa_fx_q16", ops, [&] {
+        return pass_kernel(outfx, [&](double* o) { signal_soa_fx(sfx, a1, a2, o); }, iters); });
+}
+
+//=============================
+// Extension: Heterogeneous composition (Virtual multi)
+//=============================
+static double pass_virtual_multi(const std::vector<Quote>& ticks,
+                                 const std::vector<IStrategy*>& strategies, int iters) {
     volatile double sink = 0.0;
     for (int r = 0; r < iters; ++r) {
         for (const auto& q : ticks) {
@@ -135,17 +276,50 @@ static double run_virtual_multi(const std::vector<Quote>& ticks, int iters) {
             }
         }
     }
-    double ns = t.stop_ns();
-    std::printf("%-18s time: %.3f ms sink=%.6f\n", "virtual_multi", ns/1e6, sink);
-    return ns;
+    return sink;
+}
+
+//=============================
+// Extension: Type-sorted batch (devirtualized virtual multi)
+//=============================
+// Same IStrategy* set as virtual_multi, but strategies are bucketed by concrete type and
+// each bucket runs over a block of ticks with a direct (final-class) call. Signals land
+// in out[strategy][tick] and the sink is accumulated in exactly virtual_multi's order,
+// with the same volatile add per signal.
+using StrategyBatch = TypeSortedBatch<IStrategy, SignalStrategyVirtual, SpreadStrategyVirtual>;
+
+static double pass_batch_multi(const std::vector<Quote>& ticks,
+                               const std::vector<IStrategy*>& strategies,
+                               StrategyBatch& batch, std::vector<double>& out, int iters) {
+    constexpr size_t kBlock = 256; // ticks per block: block x strategies stays in L1
+    const size_t n = ticks.size();
+    const size_t S = strategies.size();
+    out.resize(kBlock * S);
+    batch.bucketize(S, [&](size_t i) { return strategies[i]; });
+
+    double* __restrict o = out.data();
+    const Quote* __restrict q = ticks.data();
+    volatile double sink = 0.0;
+    for (int r = 0; r < iters; ++r) {
+        for (size_t b0 = 0; b0 < n; b0 += kBlock) {
+            const size_t len = std::min(kBlock, n - b0);
+            batch.for_each([&](size_t si, auto& strat) {
+                double* __restrict os = o + si * kBlock;
+                for (size_t t = 0; t < len; ++t)
+                    os[t] = strat.on_tick(q[b0 + t]);
+            });
+            for (size_t t = 0; t < len; ++t)
+                for (size_t si = 0; si < S; ++si) sink = sink + o[si * kBlock + t] * 1e-9;
+        }
+    }
+    return sink;
 }
 
 //=============================
 // Extension: Heterogeneous composition (CRTP multi)
 //=============================
 template <typename... Strategies>
-static double run_static_multi(const std::vector<Quote>& ticks, int iters, Strategies&&... s) {
-    Timer t; t.start();
+static double pass_static_multi(const std::vector<Quote>& ticks, int iters, Strategies&... s) {
     volatile double sink = 0.0;
     for (int r = 0; r < iters; ++r) {
         for (const auto& q : ticks) {
@@ -153,32 +327,65 @@ static double run_static_multi(const std::vector<Quote>& ticks, int iters, Strat
             ( (sink += s.on_tick(q) * 1e-9), ... );
         }
     }
-    double ns = t.stop_ns();
-    std::printf("%-18s time: %.3f ms sink=%.6f\n", "crtp_multi", ns/1e6, sink);
-    return ns;
+    return sink;
 }
 
 //=============================
 // Reporting helpers
 //=============================
-static void report_one(const char* name, double ns, double ops_per_tick, double n_ticks_total) {
-    const double total_ops  = n_ticks_total * ops_per_tick;
-    const double ns_per_op  = ns / total_ops;
-    const double tps        = 1e9 / ns_per_op;
+static void report_one(const BenchResult& r, double ops_per_tick) {
+    const double ns_per_op = r.ns_per_op.median;
+    const double tps       = 1e9 / ns_per_op;
     std::printf("%-18s ns/op:   %.3f  ops/sec: %.2f M  (%.1f ops/tick)\n",
-                name, ns_per_op, tps / 1e6, ops_per_tick);
+                r.name.c_str(), ns_per_op, tps / 1e6, ops_per_tick);
+}
+
+// Flags after the positional args: --reps=N --warmup=N --pin=CPU --counters
+// --format=text|json|csv --out=FILE
+static bool parse_flag(std::string_view arg, BenchConfig& cfg) {
+    auto value = [&](std::string_view key, std::string_view& out) {
+        if (arg.substr(0, key.size()) != key) return false;
+        out = arg.substr(key.size());
+        return true;
+    };
+    std::string_view v;
+    if (arg == "--counters")          { cfg.counters = true; return true; }
+    if (value("--reps=", v))          { cfg.reps    = std::atoi(std::string(v).c_str()); return true; }
+    if (value("--warmup=", v))        { cfg.warmup  = std::atoi(std::string(v).c_str()); return true; }
+    if (value("--pin=", v))           { cfg.pin_cpu = std::atoi(std::string(v).c_str()); return true; }
+    if (value("--format=", v))        { cfg.format  = std::string(v); return true; }
+    if (value("--out=", v))           { cfg.out     = std::string(v); return true; }
+    return false;
 }
 
 int main(int argc, char** argv) {
     // Parameters (can be overridden from CLI)
     uint32_t n_ticks = 10'000'000; // 10M
-    int      iters   = 1;
+    int      iters   = 1;          // passes over the stream per timed sample
     double   a1      = 0.75;
     double   a2      = 0.25;
     uint32_t seed    = 0xC001D00D;
 
-    if (argc > 1) n_ticks = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
-    if (argc > 2) iters   = std::atoi(argv[2]);
+    BenchConfig cfg;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg.substr(0, 2) == "--") {
+            if (!parse_flag(arg, cfg)) {
+                std::fprintf(stderr, "unknown flag: %s\n", argv[i]);
+                return 1;
+            }
+            continue;
+        }
+        if (positional == 0) n_ticks = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+        if (positional == 1) iters   = std::atoi(argv[i]);
+        ++positional;
+    }
+
+    BenchRunner runner(cfg);
+    const double n_total = static_cast<double>(n_ticks) * iters;
+    std::printf("warmup=%d reps=%d pin=%d counters=%s\n",
+                cfg.warmup, cfg.reps, cfg.pin_cpu, cfg.counters ? "on" : "off");
 
     //========================
     // AoS benchmarks (main assignment)
@@ -187,25 +394,84 @@ int main(int argc, char** argv) {
     std::vector<Quote> ticks;
     generate_ticks(ticks, n_ticks, seed);
 
-    auto ns_free = run_bench("free_function", ticks,
-        [&](const Quote& q) { return signal_free(q, a1, a2); }, iters);
+    // 单策略：每 tick 1 次信号计算 → ops_per_tick = 1
+    runner.run("free_function", n_total, [&] {
+        return pass_aos(ticks, [&](const Quote& q) { return signal_free(q, a1, a2); }, iters); });
 
     SignalStrategyVirtual virt(a1, a2);
     IStrategy* s = &virt;
-    auto ns_virtual = run_bench("virtual_call", ticks,
-        [&](const Quote& q) { return s->on_tick(q); }, iters);
+    runner.run("virtual_call", n_total, [&] {
+        return pass_aos(ticks, [&](const Quote& q) { return s->on_tick(q); }, iters); });
 
     SignalStrategyCRTP crtp(a1, a2);
-    auto ns_crtp = run_bench("crtp_call", ticks,
-        [&](const Quote& q) { return crtp.on_tick(q); }, iters);
+    runner.run("crtp_call", n_total, [&] {
+        return pass_aos(ticks, [&](const Quote& q) { return crtp.on_tick(q); }, iters); });
 
     //========================
     // Extensions: Heterogeneous composition (3 strategies)
     //========================
-    auto ns_vmulti = run_virtual_multi(ticks, iters);
+    // 多策略：每 tick 3 次信号计算 → ops_per_tick = 3
+    SignalStrategyVirtual v1(0.70, 0.30), v2(0.60, 0.40), v3(0.80, 0.20);
+    std::vector<IStrategy*> strategies = { &v1, &v2, &v3 };
+    runner.run("virtual_multi", 3.0 * n_total, [&] {
+        return pass_virtual_multi(ticks, strategies, iters); });
+
+    SpreadStrategyVirtual p0(0.50, 0.50);
+    StrategyBatch batch(v1, p0);
+    std::vector<double> batch_out;
+    runner.run("batch_multi", 3.0 * n_total, [&] {
+        return pass_batch_multi(ticks, strategies, batch, batch_out, iters); });
 
     SignalStrategyCRTP c1(0.70, 0.30), c2(0.60, 0.40), c3(0.80, 0.20);
-    auto ns_smulti = run_static_multi(ticks, iters, c1, c2, c3);
+    runner.run("crtp_multi", 3.0 * n_total, [&] {
+        return pass_static_multi(ticks, iters, c1, c2, c3); });
+
+    // 混合类型：8 个策略、两种具体类型交错排列 → 每 tick 8 次调用，间接跳转目标交替
+    SpreadStrategyVirtual p1(0.55, 0.45), p2(0.65, 0.35), p3(0.75, 0.25), p4(0.85, 0.15);
+    SignalStrategyVirtual v4(0.90, 0.10);
+    std::vector<IStrategy*> mixed = { &v1, &p1, &p2, &v2, &p3, &v3, &v4, &p4 };
+    const double n_mixed = double(mixed.size()) * n_total;
+    runner.run("virtual_mixed", n_mixed, [&] {
+        return pass_virtual_multi(ticks, mixed, iters); });
+    runner.run("batch_mixed", n_mixed, [&] {
+        return pass_batch_multi(ticks, mixed, batch, batch_out, iters); });
+
+    SpreadStrategyCRTP cp1(0.55, 0.45), cp2(0.65, 0.35), cp3(0.75, 0.25), cp4(0.85, 0.15);
+    SignalStrategyCRTP c4(0.90, 0.10);
+    runner.run("crtp_mixed", n_mixed, [&] {
+        return pass_static_multi(ticks, iters, c1, cp1, cp2, c2, cp3, c3, c4, cp4); });
+
+    //========================
+    // Extensions: Signal → order pipeline (same 3-strategy bundles)
+    //========================
+    // 信号经过阈值与风控限额生成订单，测量逐 tick 的 tick→order 延迟
+    PipelineConfig pcfg;
+    const size_t order_cap = ticks.size() / 4 + 1; // ~17% of synthetic ticks fire
+    StaticBundle<SignalStrategyCRTP, SignalStrategyCRTP, SignalStrategyCRTP> sbundle(c1, c2, c3);
+    auto vpipe = make_pipeline([&](const Quote& q) { return run_virtual_bundle(q, strategies); },
+                               pcfg, ticks.size(), order_cap);
+    auto spipe = make_pipeline([&](const Quote& q) { return sbundle.on_tick(q); },
+                               pcfg, ticks.size(), order_cap);
+
+    runner.run("virtual_pipeline", n_total, [&] {
+        int64_t pos = 0;
+        for (int r = 0; r < iters; ++r) pos += vpipe.run(ticks);
+        return pos; });
+    runner.run("crtp_pipeline", n_total, [&] {
+        int64_t pos = 0;
+        for (int r = 0; r < iters; ++r) pos += spipe.run(ticks);
+        return pos; });
+
+    const double cyc_per_ns = cycles_per_ns();
+    report_latency("virtual_pipeline", vpipe.latency(), cyc_per_ns);
+    report_latency("crtp_pipeline",    spipe.latency(), cyc_per_ns);
+    for (const auto* st : { &vpipe.stats(), &spipe.stats() }) {
+        std::printf("%-18s orders: %llu (buy %llu / sell %llu)  risk_rejects: %llu  buffer_full: %llu  position: %d\n",
+                    st == &vpipe.stats() ? "virtual_pipeline" : "crtp_pipeline",
+                    (unsigned long long)st->orders, (unsigned long long)st->buys,
+                    (unsigned long long)st->sells, (unsigned long long)st->risk_rejects,
+                    (unsigned long long)st->buffer_full, st->position);
+    }
 
     //========================
     // Extensions: SoA layout
@@ -214,25 +480,25 @@ int main(int argc, char** argv) {
     QuotesSoA qsoa;
     generate_ticks_soa(qsoa, n_ticks, seed ^ 0x9E3779B9u); // 不同seed，避免cache复用侥幸
 
-    auto ns_soa = run_bench_soa(qsoa, a1, a2, iters, "soa_baseline");
+    runner.run("soa_baseline", n_total, [&] {
+        return pass_soa(qsoa, a1, a2, iters); });
 
     //========================
-    // Summary
+    // Extensions: float32 / fixed-point kernels
     //========================
-    std::puts("\n=== Summary ===");
-    // 单策略：每 tick 1 次信号计算 → ops_per_tick = 1
-    report_one("free_function", ns_free,   /*ops/tick*/ 1.0, static_cast<double>(n_ticks) * iters);
-    report_one("virtual_call",  ns_virtual,/*ops/tick*/ 1.0, static_cast<double>(n_ticks) * iters);
-    report_one("crtp_call",     ns_crtp,   /*ops/tick*/ 1.0, static_cast<double>(n_ticks) * iters);
+    std::cout << "Precision study (tick grid " << kTickSize << ")...\n";
+    run_precision_study(runner, ticks, a1, a2, iters);
 
-    // 多策略：每 tick 3 次信号计算 → ops_per_tick = 3
-    report_one("virtual_multi", ns_vmulti, /*ops/tick*/ 3.0, static_cast<double>(n_ticks) * iters);
-    report_one("crtp_multi",    ns_smulti, /*ops/tick*/ 3.0, static_cast<double>(n_ticks) * iters);
+    //========================
+    // Summary (median ns/op across reps)
+    //========================
+    std::puts("\n=== Summary ===");
+    for (const BenchResult& r : runner.results())
+        report_one(r, r.ops_per_pass / n_total);
 
-    // SoA：每 tick 1 次信号计算 → ops_per_tick = 1
-    report_one("soa_baseline",  ns_soa,    /*ops/tick*/ 1.0, static_cast<double>(n_ticks) * iters);
+    runner.emit();
 
-    std::puts("\nTip (Linux): taskset -c 0 ./hft 20000000 1");
-    std::puts("perf stat -e cycles,instructions,branches,branch-misses ./hft 20000000 1");
+    std::puts("\nFlags: --reps=N --warmup=N --pin=CPU --counters --format=text|json|csv --out=FILE");
+    std::puts("e.g. ./hft 20000000 1 --pin=0 --counters --reps=31 --format=json");
     return 0;
 }
@@ -2,6 +2,20 @@
 #include <vector>
 #include <chrono>
 #include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <type_traits>
+#include <memory>
+#include <new>
+#include <thread>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FAST_MATRIX_X86 1
+#include <immintrin.h>
+#endif
+// Build: g++ -std=c++17 -O2 -pthread fast_matrix.cpp
 
 using namespace std;
 
@@ -90,53 +104,446 @@ long long sumMatrixSinglePointer(const vector<vector<int>>& m) {
 }
 
 
+//Contiguous matrix: one 64-byte aligned block, rows back to back.
+//vector<vector<int>> makes SIZE separate heap allocations, so every row starts a new stream
+//for the prefetcher and carries its own 24-byte header; here the whole grid is one linear
+//array and every reduction below just walks (pointer, count).
+template <typename T>
+class FlatGrid {
+public:
+    FlatGrid(int rows, int cols)
+        : rows_(rows), cols_(cols),
+          data_(static_cast<T*>(::operator new[](sizeof(T) * size_t(rows) * cols, std::align_val_t(kAlign)))) {}
+
+    int rows() const noexcept { return rows_; }
+    int cols() const noexcept { return cols_; }
+    size_t size() const noexcept { return size_t(rows_) * cols_; }
+    const T* data() const noexcept { return data_.get(); }
+    T* row(int r) noexcept { return data_.get() + size_t(r) * cols_; }
+    const T* row(int r) const noexcept { return data_.get() + size_t(r) * cols_; }
+    T& operator()(int r, int c) noexcept { return row(r)[c]; }
+    T operator()(int r, int c) const noexcept { return row(r)[c]; }
+
+private:
+    static constexpr size_t kAlign = 64;
+    struct Free {
+        void operator()(T* p) const noexcept { ::operator delete[](p, std::align_val_t(kAlign)); }
+    };
+    int rows_, cols_;
+    std::unique_ptr<T[], Free> data_;
+};
+using FlatMatrix = FlatGrid<int>;
+
+//Baseline on the flat layout: same single accumulator as sumMatrixRowPointer.
+long long sumRangeScalar(const int* p, size_t n) {
+    long long sum = 0;
+    for (size_t k = 0; k < n; ++k) sum += p[k];
+    return sum;
+}
+
+//Eight independent accumulators: one long long add chain is bound by the 1-cycle add
+//latency, eight chains let the core retire several adds per cycle.
+long long sumRangeMultiAcc(const int* p, size_t n) {
+    long long a0 = 0, a1 = 0, a2 = 0, a3 = 0, a4 = 0, a5 = 0, a6 = 0, a7 = 0;
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        a0 += p[k + 0]; a1 += p[k + 1]; a2 += p[k + 2]; a3 += p[k + 3];
+        a4 += p[k + 4]; a5 += p[k + 5]; a6 += p[k + 6]; a7 += p[k + 7];
+    }
+    for (; k < n; ++k) a0 += p[k];
+    return ((a0 + a1) + (a2 + a3)) + ((a4 + a5) + (a6 + a7));
+}
+
+#ifdef FAST_MATRIX_X86
+//AVX2: 16 ints per iteration, each 128-bit half sign-extended to four int64 lanes
+//(vpmovsxdq) and added into its own accumulator, so the sum can't overflow like an
+//int32 vector sum would.
+__attribute__((target("avx2")))
+long long sumRangeAVX2(const int* p, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+    size_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k + 8));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v0)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v0, 1)));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v1)));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v1, 1)));
+    }
+    const __m256i acc = _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3));
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    long long sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; k < n; ++k) sum += p[k];
+    return sum;
+}
+#endif
+
+bool hasAVX2() {
+#ifdef FAST_MATRIX_X86
+    static const bool ok = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return ok;
+#else
+    return false;
+#endif
+}
+
+//Widest kernel this CPU can run
+long long sumRangeBest(const int* p, size_t n) {
+#ifdef FAST_MATRIX_X86
+    if (hasAVX2()) return sumRangeAVX2(p, n);
+#endif
+    return sumRangeMultiAcc(p, n);
+}
+
+long long sumFlatScalar(const FlatMatrix& m)   { return sumRangeScalar(m.data(), m.size()); }
+long long sumFlatMultiAcc(const FlatMatrix& m) { return sumRangeMultiAcc(m.data(), m.size()); }
+long long sumFlatSIMD(const FlatMatrix& m)     { return sumRangeBest(m.data(), m.size()); }
+
+//Each thread sums a contiguous block of rows with the SIMD kernel into its own cache
+//line (no false sharing), and the partial sums are added after join. Threads are started
+//per call, which costs tens of microseconds: small next to a 64 MB pass.
+long long sumFlatThreaded(const FlatMatrix& m, unsigned threads) {
+    threads = std::max(1u, std::min<unsigned>(threads, unsigned(m.rows())));
+    struct alignas(64) Partial { long long sum = 0; };
+    std::vector<Partial> partial(threads);
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    auto work = [&](unsigned t) {
+        const int r0 = int(size_t(m.rows()) * t / threads);
+        const int r1 = int(size_t(m.rows()) * (t + 1) / threads);
+        partial[t].sum = sumRangeBest(m.row(r0), size_t(r1 - r0) * m.cols());
+    };
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto& th : pool) th.join();
+    long long sum = 0;
+    for (const Partial& p : partial) sum += p.sum;
+    return sum;
+}
+
+//======================= Reduction engine =======================
+//An op is a policy struct:
+//  Acc            running state (wide enough not to overflow: long long for integer sums)
+//  identity()     empty state
+//  reduce(p, n)   state of a contiguous run, several independent accumulators
+//  combine(a, b)  merge two states
+//  finish(a)      -> result
+//  colBlock(p, rows, cols, out)  per-column state of a block of consecutive rows
+//Elementwise ops (sum/min/max) get reduce/colBlock from ElementwiseOp through step(acc, x).
+//
+//Traversal is always row order. Column reductions take kColBlockBytes of rows at a time
+//and walk each row left to right, updating a cols-long accumulator row that stays in L1/L2,
+//instead of striding down one column at a time (one cache line and often one TLB entry per
+//element).
+constexpr size_t kColBlockBytes = 256 * 1024;
+
+template <typename Derived, typename T, typename AccT>
+struct ElementwiseOp {
+    using Acc = AccT;
+    static Acc reduce(const T* p, size_t n) {
+        Acc a0 = Derived::identity(), a1 = a0, a2 = a0, a3 = a0;
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+            a0 = Derived::step(a0, p[k + 0]); a1 = Derived::step(a1, p[k + 1]);
+            a2 = Derived::step(a2, p[k + 2]); a3 = Derived::step(a3, p[k + 3]);
+        }
+        for (; k < n; ++k) a0 = Derived::step(a0, p[k]);
+        return Derived::combine(Derived::combine(a0, a1), Derived::combine(a2, a3));
+    }
+    static void colBlock(const T* p, size_t rows, size_t cols, Acc* out) {
+        for (size_t j = 0; j < cols; ++j) out[j] = Derived::identity();
+        for (size_t i = 0; i < rows; ++i, p += cols)
+            for (size_t j = 0; j < cols; ++j) out[j] = Derived::step(out[j], p[j]);
+    }
+    static Acc finish(Acc a) { return a; }
+};
+
+template <typename T>
+using WideSum = std::conditional_t<std::is_integral_v<T>, long long, double>;
+
+template <typename T>
+struct SumOp : ElementwiseOp<SumOp<T>, T, WideSum<T>> {
+    using Acc = WideSum<T>;
+    static Acc identity() { return Acc(0); }
+    static Acc step(Acc a, T x) { return a + x; }
+    static Acc combine(Acc a, Acc b) { return a + b; }
+};
+
+template <typename T>
+struct MinOp : ElementwiseOp<MinOp<T>, T, T> {
+    static T identity() { return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                      : std::numeric_limits<T>::max(); }
+    static T step(T a, T x) { return x < a ? x : a; }
+    static T combine(T a, T b) { return step(a, b); }
+};
+
+template <typename T>
+struct MaxOp : ElementwiseOp<MaxOp<T>, T, T> {
+    static T identity() { return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                                      : std::numeric_limits<T>::lowest(); }
+    static T step(T a, T x) { return x > a ? x : a; }
+    static T combine(T a, T b) { return step(a, b); }
+};
+
+struct MeanVar { double mean, variance; }; // population variance
+
+//Mean and variance: two passes over each run while it is still in cache (sum, then squared
+//deviations from the run's mean), and runs merged with Chan's pairwise update. This avoids
+//both the cancellation of sum(x^2) - n*mean^2 and a second sweep over the whole grid.
+template <typename T>
+struct MomentsOp {
+    struct Acc { double n, mean, m2; };
+    static Acc identity() { return {0.0, 0.0, 0.0}; }
+    static Acc reduce(const T* p, size_t n) {
+        if (n == 0) return identity();
+        const double mean = double(SumOp<T>::reduce(p, n)) / double(n);
+        double d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+            const double e0 = p[k + 0] - mean, e1 = p[k + 1] - mean;
+            const double e2 = p[k + 2] - mean, e3 = p[k + 3] - mean;
+            d0 += e0 * e0; d1 += e1 * e1; d2 += e2 * e2; d3 += e3 * e3;
+        }
+        for (; k < n; ++k) { const double e = p[k] - mean; d0 += e * e; }
+        return {double(n), mean, (d0 + d1) + (d2 + d3)};
+    }
+    static Acc combine(const Acc& a, const Acc& b) {
+        if (a.n == 0) return b;
+        if (b.n == 0) return a;
+        const double n = a.n + b.n, d = b.mean - a.mean;
+        return {n, a.mean + d * (b.n / n), a.m2 + b.m2 + d * d * (a.n * b.n / n)};
+    }
+    static void colBlock(const T* p, size_t rows, size_t cols, Acc* out) {
+        std::vector<double> mean(cols, 0.0), m2(cols, 0.0);
+        const T* q = p;
+        for (size_t i = 0; i < rows; ++i, q += cols)
+            for (size_t j = 0; j < cols; ++j) mean[j] += q[j];
+        for (size_t j = 0; j < cols; ++j) mean[j] /= double(rows);
+        q = p;
+        for (size_t i = 0; i < rows; ++i, q += cols)
+            for (size_t j = 0; j < cols; ++j) { const double e = q[j] - mean[j]; m2[j] += e * e; }
+        for (size_t j = 0; j < cols; ++j) out[j] = {double(rows), mean[j], m2[j]};
+    }
+    static MeanVar finish(const Acc& a) { return {a.mean, a.n > 0 ? a.m2 / a.n : 0.0}; }
+};
+
+template <typename T>
+size_t colBlockRows(const FlatGrid<T>& m) {
+    return std::max<size_t>(1, kColBlockBytes / (sizeof(T) * size_t(std::max(1, m.cols()))));
+}
+
+//Whole grid: one reduce per row block, states combined
+template <typename Op, typename T>
+auto reduceAll(const FlatGrid<T>& m) {
+    const size_t block = colBlockRows(m);
+    typename Op::Acc acc = Op::identity();
+    for (size_t r = 0; r < size_t(m.rows()); r += block) {
+        const size_t rows = std::min(block, size_t(m.rows()) - r);
+        acc = Op::combine(acc, Op::reduce(m.row(int(r)), rows * m.cols()));
+    }
+    return Op::finish(acc);
+}
+
+//One result per row
+template <typename Op, typename T>
+auto reduceRows(const FlatGrid<T>& m) {
+    std::vector<decltype(Op::finish(Op::identity()))> out(m.rows());
+    for (int r = 0; r < m.rows(); ++r) out[r] = Op::finish(Op::reduce(m.row(r), m.cols()));
+    return out;
+}
+
+//One result per column, a row block at a time
+template <typename Op, typename T>
+auto reduceCols(const FlatGrid<T>& m) {
+    const size_t cols = m.cols(), block = colBlockRows(m);
+    std::vector<typename Op::Acc> acc(cols, Op::identity()), part(cols);
+    for (size_t r = 0; r < size_t(m.rows()); r += block) {
+        const size_t rows = std::min(block, size_t(m.rows()) - r);
+        Op::colBlock(m.row(int(r)), rows, cols, part.data());
+        for (size_t j = 0; j < cols; ++j) acc[j] = Op::combine(acc[j], part[j]);
+    }
+    std::vector<decltype(Op::finish(Op::identity()))> out(cols);
+    for (size_t j = 0; j < cols; ++j) out[j] = Op::finish(acc[j]);
+    return out;
+}
+
+//Naive references: a double loop through operator() into one double, columns walked
+//top to bottom; mean/variance is the textbook mean pass then deviation pass.
+//run(ni, nj, get) reduces get(i, j) over an ni x nj index range.
+struct NaiveSum {
+    template <typename G> static double run(int ni, int nj, G get) {
+        double s = 0.0;
+        for (int i = 0; i < ni; ++i)
+            for (int j = 0; j < nj; ++j) s += get(i, j);
+        return s;
+    }
+};
+struct NaiveMin {
+    template <typename G> static double run(int ni, int nj, G get) {
+        double v = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < ni; ++i)
+            for (int j = 0; j < nj; ++j) v = std::min(v, get(i, j));
+        return v;
+    }
+};
+struct NaiveMax {
+    template <typename G> static double run(int ni, int nj, G get) {
+        double v = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < ni; ++i)
+            for (int j = 0; j < nj; ++j) v = std::max(v, get(i, j));
+        return v;
+    }
+};
+struct NaiveMoments {
+    template <typename G> static MeanVar run(int ni, int nj, G get) {
+        const double n = double(ni) * nj;
+        const double mean = NaiveSum::run(ni, nj, get) / n;
+        double m2 = 0.0;
+        for (int i = 0; i < ni; ++i)
+            for (int j = 0; j < nj; ++j) { const double e = get(i, j) - mean; m2 += e * e; }
+        return {mean, m2 / n};
+    }
+};
+
+template <typename N, typename T>
+auto naiveAll(const FlatGrid<T>& m) {
+    return N::run(m.rows(), m.cols(), [&](int i, int j) { return double(m(i, j)); });
+}
+template <typename N, typename T>
+auto naiveRows(const FlatGrid<T>& m) {
+    std::vector<decltype(naiveAll<N>(m))> out(m.rows());
+    for (int r = 0; r < m.rows(); ++r)
+        out[r] = N::run(1, m.cols(), [&](int, int j) { return double(m(r, j)); });
+    return out;
+}
+template <typename N, typename T>
+auto naiveCols(const FlatGrid<T>& m) {
+    std::vector<decltype(naiveAll<N>(m))> out(m.cols());
+    for (int c = 0; c < m.cols(); ++c)
+        out[c] = N::run(m.rows(), 1, [&](int i, int) { return double(m(i, c)); });
+    return out;
+}
+
+//Engine vs naive: relative 1e-9 (summation order differs for doubles)
+bool closeTo(double a, double b) {
+    return std::abs(a - b) <= 1e-9 * std::max({1.0, std::abs(a), std::abs(b)});
+}
+bool closeTo(const MeanVar& a, const MeanVar& b) {
+    return closeTo(a.mean, b.mean) && closeTo(a.variance, b.variance);
+}
+template <typename A, typename B>
+bool closeTo(const std::vector<A>& a, const std::vector<B>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t k = 0; k < a.size(); ++k)
+        if (!closeTo(a[k], b[k])) return false;
+    return true;
+}
+template <typename A>
+bool closeTo(const A& a, double b) { return closeTo(double(a), b); }
+
+//Best of `runs` wall times in nanoseconds; the last result is kept for checking
+template <typename F, typename R>
+long long timeNs(F&& f, R& result, int runs = 5) {
+    long long best = -1;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        result = f();
+        auto t1 = std::chrono::steady_clock::now();
+        const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        if (best < 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+template <typename NaiveFn, typename EngineFn>
+void benchShape(const char* grid, const char* op, const char* shape, NaiveFn naive, EngineFn engine) {
+    decltype(naive()) ref{};
+    decltype(engine()) got{};
+    const long long naive_ns  = timeNs(naive, ref, 3);
+    const long long engine_ns = timeNs(engine, got, 3);
+    std::printf("%-7s %-9s %-5s %12lld  %12lld  %6.2fx  %s\n", grid, op, shape, naive_ns, engine_ns,
+                double(naive_ns) / double(engine_ns), closeTo(got, ref) ? "OK" : "MISMATCH");
+}
+
+template <typename Op, typename Naive, typename T>
+void benchOp(const char* grid, const char* op, const FlatGrid<T>& m) {
+    benchShape(grid, op, "all",  [&] { return naiveAll<Naive>(m); },  [&] { return reduceAll<Op>(m); });
+    benchShape(grid, op, "rows", [&] { return naiveRows<Naive>(m); }, [&] { return reduceRows<Op>(m); });
+    benchShape(grid, op, "cols", [&] { return naiveCols<Naive>(m); }, [&] { return reduceCols<Op>(m); });
+}
+
+template <typename T>
+void benchReductions(const char* grid, const FlatGrid<T>& m) {
+    benchOp<SumOp<T>,     NaiveSum>    (grid, "sum",      m);
+    benchOp<MinOp<T>,     NaiveMin>    (grid, "min",      m);
+    benchOp<MaxOp<T>,     NaiveMax>    (grid, "max",      m);
+    benchOp<MomentsOp<T>, NaiveMoments>(grid, "mean/var", m);
+}
+
+void report(const char* name, long long sum, long long ns, long long ref, long long base_ns) {
+    std::printf("%-22s sum=%-12lld %12lld ns  %8.3f ms  %6.2fx  %s\n", name, sum, ns, ns / 1e6,
+                double(base_ns) / double(ns), sum == ref ? "OK" : "MISMATCH");
+}
+
 int main() {
     // Generate a large random matrix
     std::vector<std::vector<int>> matrix(SIZE, std::vector<int>(SIZE));
+    FlatMatrix flat(SIZE, SIZE);
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> distrib(-100, 100);
     for (int i = 0; i < SIZE; ++i) {
         for (int j = 0; j < SIZE; ++j) {
             matrix[i][j] = distrib(gen);
+            flat(i, j) = matrix[i][j];
         }
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
-    long long sum = sumMatrixBasic(matrix);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-
-    std::cout << "Basic Sum: " << sum << std::endl;
-    std::cout << "Basic Time: " << duration.count() << " milliseconds" << std::endl;
-
-    // Students will implement their optimized version here
-    auto start_optimized = std::chrono::high_resolution_clock::now();
-    long long optimized_sum = sumMatrixInlineIndex(matrix); // Students will calculate this
-    auto end_optimized = std::chrono::high_resolution_clock::now();
-    auto duration_optimized = std::chrono::duration_cast<std::chrono::milliseconds>(end_optimized - start_optimized);
-
-    std::cout << "Optimized Sum: " << optimized_sum << std::endl;
-    std::cout << "Optimized Time: " << duration_optimized.count() << " milliseconds" << std::endl;
+    //Every variant is checked against sumMatrixBasic; times are best of 5, speedup vs basic
+    long long ref = 0;
+    const long long base_ns = timeNs([&] { return sumMatrixBasic(matrix); }, ref);
+    std::printf("%dx%d int32 (%zu MB), AVX2 %s, %u hardware threads\n", SIZE, SIZE,
+                flat.size() * sizeof(int) >> 20, hasAVX2() ? "yes" : "no",
+                std::thread::hardware_concurrency());
+    report("Basic", ref, base_ns, ref, base_ns);
 
-    auto start_b = std::chrono::high_resolution_clock::now();
-    long long b_sum = sumMatrixRowPointer(matrix); // Students will calculate this
-    auto end_b = std::chrono::high_resolution_clock::now();
-    auto duration_b = std::chrono::duration_cast<std::chrono::milliseconds>(end_b - start_b);
+    long long sum = 0, ns = 0;
+    ns = timeNs([&] { return sumMatrixInlineIndex(matrix); }, sum);
+    report("InlineIndex", sum, ns, ref, base_ns);
+    ns = timeNs([&] { return sumMatrixRowPointer(matrix); }, sum);
+    report("RowPointer", sum, ns, ref, base_ns);
+    ns = timeNs([&] { return sumMatrixSinglePointer(matrix); }, sum);
+    report("SinglePointer", sum, ns, ref, base_ns);
 
-    cout << "RowPointer Sum:  " << b_sum << "\n";
-    cout << "RowPointer Time: " << duration_b.count() << " ms\n";
+    ns = timeNs([&] { return sumFlatScalar(flat); }, sum);
+    report("Flat scalar", sum, ns, ref, base_ns);
+    ns = timeNs([&] { return sumFlatMultiAcc(flat); }, sum);
+    report("Flat 8 accumulators", sum, ns, ref, base_ns);
+    ns = timeNs([&] { return sumFlatSIMD(flat); }, sum);
+    report(hasAVX2() ? "Flat AVX2 int32->int64" : "Flat SIMD (fallback)", sum, ns, ref, base_ns);
 
-    auto start_c = std::chrono::high_resolution_clock::now();
-    long long c_sum = sumMatrixSinglePointer(matrix); // Students will calculate this
-    auto end_c = std::chrono::high_resolution_clock::now();
-    auto duration_c = std::chrono::duration_cast<std::chrono::milliseconds>(end_c - start_c);
-
-    cout << "SinglePtr Sum:  " << c_sum << "\n";
-    cout << "SinglePtr Time: " << duration_c.count() << " ms\n";
+    //2, 4, ... up to the core count (always at least 2 so the path is exercised)
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned t = 2; t < hw; t *= 2) counts.push_back(t);
+    counts.push_back(std::max(2u, hw));
+    for (unsigned t : counts) {
+        ns = timeNs([&] { return sumFlatThreaded(flat, t); }, sum);
+        char name[32];
+        std::snprintf(name, sizeof(name), "Flat threaded x%u", t);
+        report(name, sum, ns, ref, base_ns);
+    }
 
+    //Reduction engine vs naive double loops, int32 grid and a double grid of the same shape
+    FlatGrid<double> flat_d(SIZE, SIZE);
+    std::uniform_real_distribution<double> distrib_d(-100.0, 100.0);
+    for (int i = 0; i < SIZE; ++i)
+        for (int j = 0; j < SIZE; ++j) flat_d(i, j) = distrib_d(gen);
+    std::printf("\n%-7s %-9s %-5s %12s  %12s  %7s\n", "grid", "op", "shape", "naive ns", "engine ns", "speedup");
+    benchReductions("int32", flat);
+    benchReductions("double", flat_d);
 
     return 0;
 }
-
-
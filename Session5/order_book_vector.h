@@ -7,6 +7,7 @@
 #pragma once
 #include "order.h"
 #include "price_level.h"
+#include <cstddef>
 #include <unordered_map>
 #include <vector>
 
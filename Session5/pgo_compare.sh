@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+# Build base / lto / pgo-gen / pgo-use variants of the order-book benchmarks, train the
+# PGO build on the benchmark workload, then print Mops/s side by side.
+# Usage: ./pgo_compare.sh
+set -euo pipefail
+cd "$(dirname "$0")"
+
+BENCHES="benchmark_heaps benchmark_map benchmark_vector"
+OUT=build/compare
+mkdir -p "$OUT"
+
+bench() { # build_dir variant
+  for b in $BENCHES; do
+    "$1/$b" | sed "s/^/$b /" > "$OUT/$2.$b.txt"
+  done
+  cat "$OUT"/"$2".*.txt > "$OUT/$2.txt"
+}
+
+for v in base lto; do
+  cmake --preset "$v" > /dev/null
+  cmake --build --preset "$v"
+  bench "build/$v" "$v"
+done
+
+# Instrumented build: measure its overhead (this run is also the training run)
+rm -rf build/pgo/pgo-data
+cmake --preset pgo-gen > /dev/null
+cmake --build --preset pgo-gen
+bench build/pgo pgo-gen
+
+if ls build/pgo/pgo-data/*.profraw > /dev/null 2>&1; then
+  llvm-profdata merge -o build/pgo/pgo-data/lob.profdata build/pgo/pgo-data/*.profraw
+fi
+
+cmake --preset pgo-use > /dev/null
+cmake --build --preset pgo-use
+bench build/pgo pgo-use
+
+# Lines look like "benchmark_heaps Insert: 1.23 Mops/s" / "... latency: 194.0 ns/query"
+echo
+awk '
+  FNR == 1 { f++ }
+  { key = $1 " " $2; if ($2 == "Top-of-book") key = $1 " top(ns)"; val[f, key] = $(NF-1)
+    if (f == 1) order[++n] = key }
+  END {
+    printf "%-26s %10s %10s %10s %10s %9s\n", "Mops/s (top: ns/query)", "base", "lto", "pgo-gen", "pgo-use", "pgo/base"
+    for (i = 1; i <= n; i++) {
+      k = order[i]
+      num = (k ~ /top/) ? val[1,k] : val[4,k]
+      den = (k ~ /top/) ? val[4,k] : val[1,k]
+      printf "%-26s %10.3f %10.3f %10.3f %10.3f ", k, val[1,k], val[2,k], val[3,k], val[4,k]
+      if (den > 0) printf "%8.2fx\n", num / den; else printf "%9s\n", "-"
+    }
+  }' "$OUT/base.txt" "$OUT/lto.txt" "$OUT/pgo-gen.txt" "$OUT/pgo-use.txt"